@@ -36,6 +36,8 @@ public:
   bool has(Boon) const;
   unsigned boonCount(Boon) const;
   unsigned getIndulgence() const;
+  // What Dracul and Tikki Tooki remember about a monster, one bit each for life stolen, hit hero and became poisoned
+  unsigned getMonsterHistory(int monsterID) const;
 
   void gainPiety(unsigned pointsGained);
   void losePiety(unsigned pointsLost, Hero& hero, Monsters& allMonsters);
@@ -123,5 +125,4 @@ private:
 
   GlowingGuardian glowingGuardian;
   Jehora jehora;
-  std::mt19937 generator{std::random_device{}()};
 };
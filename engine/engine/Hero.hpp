@@ -13,9 +13,9 @@
 #include "engine/Items.hpp"
 #include "engine/Resources.hpp"
 
-#include <map>
+#include <array>
+#include <bitset>
 #include <optional>
-#include <random>
 #include <string>
 #include <vector>
 
@@ -207,17 +207,17 @@ public:
 
 private:
   std::string name;
-  std::vector<HeroTrait> traits;
+  std::bitset<static_cast<std::size_t>(HeroTrait::Last) + 1> traits;
   HeroStats stats;
   Defence defence;
   Experience experience;
   Inventory inventory;
   Conversion conversion;
   Faith faith;
-  std::map<HeroStatus, unsigned> statuses;
-  std::map<HeroDebuff, unsigned> debuffs;
+  // Intensities indexed by enum value; Pessimist and ByssepsStacks are placed after HeroStatus::Last
+  std::array<unsigned, static_cast<std::size_t>(HeroStatus::ByssepsStacks) + 1> statuses{};
+  std::array<unsigned, static_cast<std::size_t>(HeroDebuff::Last) + 1> debuffs{};
   std::optional<PietyChange> collectedPiety;
-  std::mt19937 generator{std::random_device{}()};
   bool dodgeNext{false};
   bool alchemistScrollUsedThisLevel{false};
   bool namtarsWardUsedThisLevel{false};
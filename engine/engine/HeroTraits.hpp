@@ -67,6 +67,7 @@ enum class HeroTrait
   SwiftHand,
   Undead,
   Veteran,
+  Last = Veteran
 };
 
 constexpr const char* toString(HeroTrait trait)
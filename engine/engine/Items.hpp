@@ -4,6 +4,8 @@
 
 #include <algorithm>
 #include <array>
+#include <cstdint>
+#include <stdexcept>
 #include <string_view>
 #include <variant>
 
@@ -230,9 +232,40 @@ static constexpr Map<Item, ItemProperties, 82> items{
     {TaurogItem::Will, {"Will"sv, 0, 60, false}},
 };
 
+namespace detail
+{
+  constexpr std::size_t MaxItemsPerType = 64;
+  constexpr std::uint8_t NoItem = 0xff;
+  static_assert(items.data.size() < NoItem);
+
+  constexpr std::size_t enumValue(Item item)
+  {
+    return std::visit([](auto value) { return static_cast<std::size_t>(value); }, item);
+  }
+
+  // Position of every item in `items` by variant index and enum value, so that lookups need no linear search
+  constexpr auto itemPositions = [] {
+    std::array<std::array<std::uint8_t, MaxItemsPerType>, std::variant_size_v<Item>> positions{};
+    for (auto& row : positions)
+      row.fill(NoItem);
+    for (std::size_t i = 0; i < items.data.size(); ++i)
+      positions[items.data[i].first.index()][enumValue(items.data[i].first)] = static_cast<std::uint8_t>(i);
+    return positions;
+  }();
+
+  constexpr const ItemProperties& properties(Item item)
+  {
+    const auto value = enumValue(item);
+    const auto position = value < MaxItemsPerType ? itemPositions[item.index()][value] : NoItem;
+    if (position == NoItem)
+      throw std::range_error("Not found");
+    return items.data[position].second;
+  }
+} // namespace detail
+
 constexpr const char* toString(Item item)
 {
-  return items.at(item).name.data();
+  return detail::properties(item).name.data();
 }
 
 template <class ItemSubtype>
@@ -243,15 +276,15 @@ constexpr const char* toString(ItemSubtype item)
 
 constexpr int price(Item item)
 {
-  return items.at(item).price;
+  return detail::properties(item).price;
 }
 
 constexpr int initialConversionPoints(Item item)
 {
-  return items.at(item).conversionPoints;
+  return detail::properties(item).conversionPoints;
 }
 
 constexpr int isSmall(Item item)
 {
-  return items.at(item).isSmall;
+  return detail::properties(item).isSmall;
 }
@@ -1,7 +1,6 @@
 #pragma once
 
 #include <optional>
-#include <random>
 
 class Hero;
 
@@ -15,7 +14,6 @@ public:
   void applyRandomPunishment(Hero& hero);
 
 private:
-  std::mt19937 generator{std::random_device{}()};
   unsigned happiness;
   unsigned thresholdPoison;
   unsigned thresholdManaBurn;
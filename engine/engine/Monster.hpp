@@ -6,6 +6,7 @@
 #include "engine/MonsterTraits.hpp"
 #include "engine/Resources.hpp"
 
+#include <atomic>
 #include <memory>
 #include <string>
 #include <random>
@@ -83,7 +84,8 @@ public:
   bool grantsXP() const { return true; }
 
 private:
-  std::string name;
+  // Names are interned and shared between all monsters of the same name, so that monsters are trivially copyable
+  const std::string* name;
   int id;
 
   MonsterStats stats;
@@ -91,7 +93,8 @@ private:
   MonsterStatus status;
   MonsterTraits traits;
 
-  static int lastId;
+  // Incremented atomically so that monsters can be created concurrently (e.g. when solvers uncover tiles in parallel)
+  static std::atomic<int> lastId;
 };
 
 //! A hidden monster can be either a specific but currently not uncovered monster, or an unknown monster of known level
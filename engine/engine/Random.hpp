@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstdint>
+#include <limits>
+
+//! Small, fast pseudo-random bit generator (SplitMix64).  Satisfies UniformRandomBitGenerator, i.e. it can be used
+//! with the standard random distributions and algorithms.
+class RandomGenerator
+{
+public:
+  using result_type = std::uint64_t;
+
+  explicit constexpr RandomGenerator(std::uint64_t seed)
+    : counter(seed)
+  {
+  }
+
+  static constexpr result_type min() { return std::numeric_limits<result_type>::min(); }
+  static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+
+  constexpr result_type operator()()
+  {
+    auto z = (counter += 0x9e3779b97f4a7c15ull);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+    return z ^ (z >> 31);
+  }
+
+private:
+  std::uint64_t counter;
+};
+
+//! Random source shared by all engine objects in the current thread (dodge rolls, Jehora, goatperson deities, ...).
+//! Seeded from std::random_device on first use in each thread.
+RandomGenerator& randomGenerator();
+
+//! Re-seed the current thread's random source, e.g. to obtain reproducible results
+void seedRandomGenerator(std::uint64_t seed);
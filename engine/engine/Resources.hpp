@@ -3,10 +3,10 @@
 #include "engine/DungeonSetup.hpp"
 #include "engine/GodsAndBoons.hpp"
 #include "engine/Items.hpp"
+#include "engine/Random.hpp"
 #include "engine/Spells.hpp"
 
 #include <optional>
-#include <random>
 #include <set>
 #include <vector>
 
@@ -17,9 +17,9 @@ struct ResourceSet
 
   bool pactmakerAvailable() const;
 
-  void addRandomShop(std::mt19937 generator);
-  void addRandomSpell(std::mt19937 generator);
-  void addRandomAltar(std::mt19937 generator);
+  void addRandomShop(RandomGenerator& generator = randomGenerator());
+  void addRandomSpell(RandomGenerator& generator = randomGenerator());
+  void addRandomAltar(RandomGenerator& generator = randomGenerator());
 
   std::vector<Item> shops;
   std::vector<Spell> spells;
@@ -112,5 +112,4 @@ struct MapResources : public Resources
 
   ResourceSet visible;
   ResourceSet hidden;
-  std::mt19937 generator{std::random_device{}()};
 };
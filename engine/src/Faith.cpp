@@ -3,10 +3,12 @@
 #include "engine/Clamp.hpp"
 #include "engine/Hero.hpp"
 #include "engine/Items.hpp"
+#include "engine/Random.hpp"
 #include "engine/Spells.hpp"
 
 #include <algorithm>
 #include <cassert>
+#include <random>
 #include <variant>
 
 Faith::Faith(std::optional<GodOrPactmaker> preparedAltar0)
@@ -46,7 +48,7 @@ void Faith::selectNextDeityForGoatperson()
     return;
   std::uniform_int_distribution<size_t> randomIndex(0u, altarsForGoatperson->size() - 1);
   if (!followedDeity)
-    followedDeity = (*altarsForGoatperson)[randomIndex(generator)];
+    followedDeity = (*altarsForGoatperson)[randomIndex(randomGenerator())];
   else
   {
     if (altarsForGoatperson->size() == 1)
@@ -58,7 +60,7 @@ void Faith::selectNextDeityForGoatperson()
       const God lastDeity = *followedDeity;
       do
       {
-        followedDeity = (*altarsForGoatperson)[randomIndex(generator)];
+        followedDeity = (*altarsForGoatperson)[randomIndex(randomGenerator())];
       } while (lastDeity == *followedDeity);
     }
   }
@@ -110,6 +112,15 @@ unsigned Faith::getIndulgence() const
   return indulgence;
 }
 
+unsigned Faith::getMonsterHistory(int monsterID) const
+{
+  const auto monsterHistory = history.find(monsterID);
+  if (monsterHistory == end(history))
+    return 0;
+  const auto& [hadLifeStolen, hitHero, becamePoisoned] = monsterHistory->second;
+  return (hadLifeStolen ? 1u : 0u) | (hitHero ? 2u : 0u) | (becamePoisoned ? 4u : 0u);
+}
+
 void Faith::gainPiety(unsigned pointsGained)
 {
   piety = std::min(piety + pointsGained, getMaxPiety());
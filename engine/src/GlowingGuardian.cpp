@@ -1,11 +1,9 @@
 #include "engine/GlowingGuardian.hpp"
 
-#include <algorithm>
+#include "engine/Random.hpp"
 
-GlowingGuardian::GlowingGuardian()
-  : generator(std::random_device{}())
-{
-}
+#include <algorithm>
+#include <random>
 
 bool GlowingGuardian::canUseAbsolution(unsigned heroLevel, const Monsters& monsters) const
 {
@@ -25,5 +23,5 @@ Monsters::iterator GlowingGuardian::pickMonsterForAbsolution(unsigned heroLevel,
   }
   if (lowerLevelMonsters.empty())
     return end(monsters);
-  return lowerLevelMonsters[std::uniform_int_distribution<size_t>(0, lowerLevelMonsters.size() - 1)(generator)];
+  return lowerLevelMonsters[std::uniform_int_distribution<size_t>(0, lowerLevelMonsters.size() - 1)(randomGenerator())];
 }
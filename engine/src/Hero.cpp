@@ -5,9 +5,11 @@
 #include "engine/Items.hpp"
 #include "engine/Magic.hpp"
 #include "engine/Monster.hpp"
+#include "engine/Random.hpp"
 
 #include <algorithm>
 #include <cassert>
+#include <random>
 #include <utility>
 
 Hero::Hero(HeroClass heroClass, HeroRace heroRace)
@@ -23,14 +25,14 @@ Hero::Hero(HeroClass monsterClass, const std::vector<God>& altarsForGoatperson)
 Hero::Hero(const DungeonSetup& setup, const std::vector<God>& altarsForGoatperson)
   : name(isMonsterClass(setup.heroClass) ? toString(setup.heroClass)
                                          : (toString(setup.heroRace) + std::string(" ") + toString(setup.heroClass)))
-  , traits(startingTraits(setup.heroClass))
   , defence(0_physicalresist, 0_magicalresist, 65_physicalresist, 65_magicalresist)
   , experience()
   , inventory(setup)
   , conversion(setup)
   , faith(setup.altar)
-  , generator(std::random_device{}())
 {
+  for (auto trait : startingTraits(setup.heroClass))
+    traits.set(static_cast<std::size_t>(trait));
   if (has(HeroTrait::Veteran))
     experience = Experience(Experience::IsVeteran{});
   if (has(HeroTrait::Dangerous))
@@ -127,16 +129,13 @@ Hero::Hero(const DungeonSetup& setup, const std::vector<God>& altarsForGoatperso
 
 Hero::Hero(HeroStats stats, Defence defence, Experience experience)
   : name("Hero")
-  , traits()
   , stats(std::move(stats))
   , defence(std::move(defence))
   , experience(std::move(experience))
   , inventory(DungeonSetup{})
   , conversion(DungeonSetup{})
   , faith()
-  , statuses()
   , collectedPiety()
-  , generator(std::random_device{}())
 {
 }
 
@@ -576,17 +575,14 @@ void Hero::addSpiritStrength()
 {
   const auto mp = getManaPoints();
   const auto newSpiritStrength = getLevel() + mp;
-  auto iter = statuses.find(HeroStatus::SpiritStrength);
-  if (iter == end(statuses))
-    statuses[HeroStatus::SpiritStrength] = newSpiritStrength;
-  else
-    iter->second = std::max(newSpiritStrength, iter->second);
+  auto& spiritStrength = statuses[static_cast<std::size_t>(HeroStatus::SpiritStrength)];
+  spiritStrength = std::max(newSpiritStrength, spiritStrength);
   loseManaPoints(mp);
 }
 
 void Hero::add(HeroStatus status, int addedIntensity)
 {
-  const int newIntensity = static_cast<int>(statuses[status]) + addedIntensity;
+  const int newIntensity = static_cast<int>(statuses[static_cast<std::size_t>(status)]) + addedIntensity;
   assert(newIntensity >= 0);
   setStatusIntensity(status, static_cast<unsigned>(newIntensity));
 }
@@ -594,7 +590,7 @@ void Hero::add(HeroStatus status, int addedIntensity)
 void Hero::reduce(HeroStatus status)
 {
   if (has(status))
-    setStatusIntensity(status, statuses[status] - 1);
+    setStatusIntensity(status, statuses[static_cast<std::size_t>(status)] - 1);
 }
 
 void Hero::reset(HeroStatus status)
@@ -614,7 +610,7 @@ void Hero::setStatusIntensity(HeroStatus status, unsigned newIntensity)
   if (newIntensity > 1 && !canHaveMultiple(status))
     newIntensity = 1;
 
-  const auto oldIntensity = std::exchange(statuses[status], newIntensity);
+  const auto oldIntensity = std::exchange(statuses[static_cast<std::size_t>(status)], newIntensity);
   if (newIntensity == oldIntensity)
     return;
 
@@ -633,8 +629,6 @@ void Hero::setStatusIntensity(HeroStatus status, unsigned newIntensity)
     else if (status == HeroStatus::PoisonImmune)
       reset(HeroDebuff::Poisoned);
   }
-  else if (newIntensity == 0)
-    statuses.erase(status);
 
   if (status == HeroStatus::DodgePermanent || status == HeroStatus::DodgeTemporary)
     rerollDodgeNext();
@@ -649,8 +643,7 @@ unsigned Hero::getIntensity(HeroStatus status) const
   if (status == HeroStatus::Exhausted)
     return has(HeroTrait::Damned) && getHitPoints() < getHitPointsMax();
 
-  auto iter = statuses.find(status);
-  return iter != statuses.end() ? iter->second : 0;
+  return statuses[static_cast<std::size_t>(status)];
 }
 
 void Hero::add(HeroDebuff debuff, Monsters& allMonsters, int addedIntensity)
@@ -672,7 +665,7 @@ void Hero::add(HeroDebuff debuff, Monsters& allMonsters, int addedIntensity)
       (debuff == HeroDebuff::Poisoned && has(HeroStatus::PoisonImmune)))
     return;
 
-  auto& intensity = debuffs[debuff];
+  auto& intensity = debuffs[static_cast<std::size_t>(debuff)];
 
   // Mana burn is special: Although one cannot have multiple layers, adding it will always set mana to 0
   if (debuff == HeroDebuff::ManaBurned)
@@ -701,11 +694,11 @@ void Hero::add(HeroDebuff debuff, Monsters& allMonsters, int addedIntensity)
 
 void Hero::reduce(HeroDebuff debuff)
 {
-  auto iter = debuffs.find(debuff);
-  if (iter == debuffs.end() || iter->second == 0)
+  auto& intensity = debuffs[static_cast<std::size_t>(debuff)];
+  if (intensity == 0)
     return;
 
-  const auto newIntensity = iter->second - 1;
+  const auto newIntensity = intensity - 1;
 
   if (newIntensity == 0)
   {
@@ -713,7 +706,7 @@ void Hero::reduce(HeroDebuff debuff)
     return;
   }
 
-  debuffs[debuff] = newIntensity;
+  intensity = newIntensity;
 
   if (debuff == HeroDebuff::Corroded)
     defence.set(CorrosionAmount{newIntensity});
@@ -721,7 +714,7 @@ void Hero::reduce(HeroDebuff debuff)
 
 void Hero::reset(HeroDebuff debuff)
 {
-  if (debuffs.erase(debuff))
+  if (std::exchange(debuffs[static_cast<std::size_t>(debuff)], 0u) > 0)
   {
     if (debuff == HeroDebuff::Corroded)
       defence.set(0_corrosion);
@@ -737,8 +730,7 @@ bool Hero::has(HeroDebuff debuff) const
 
 unsigned Hero::getIntensity(HeroDebuff debuff) const
 {
-  auto iter = debuffs.find(debuff);
-  return iter != debuffs.end() ? iter->second : 0;
+  return debuffs[static_cast<std::size_t>(debuff)];
 }
 
 void Hero::add(HeroTrait trait)
@@ -748,12 +740,12 @@ void Hero::add(HeroTrait trait)
     assert(false);
     return;
   }
-  traits.emplace_back(trait);
+  traits.set(static_cast<std::size_t>(trait));
 }
 
 bool Hero::has(HeroTrait trait) const
 {
-  return std::find(begin(traits), end(traits), trait) != end(traits);
+  return traits.test(static_cast<std::size_t>(trait));
 }
 
 void Hero::monsterKilled(
@@ -792,7 +784,7 @@ void Hero::monsterKilled(
     {
       boss->corrode();
     }
-    const auto reward = [rewardIndex = std::uniform_int_distribution<>(0, 3)(generator),
+    const auto reward = [rewardIndex = std::uniform_int_distribution<>(0, 3)(randomGenerator()),
                          corrodeReward = !monster.has(MonsterTrait::Bloodless)]() -> Item {
       switch (rewardIndex)
       {
@@ -905,7 +897,7 @@ void Hero::levelUpRefresh(Monsters& allMonsters)
   if (has(MiscItem::PatchesTheTeddy) && !has(HeroStatus::Pessimist))
   {
     // Random positive effect
-    switch (std::uniform_int_distribution<>(0, 4)(generator))
+    switch (std::uniform_int_distribution<>(0, 4)(randomGenerator()))
     {
     case 0:
       setHitPointsMax(getHitPointsMax() + 3);
@@ -925,7 +917,7 @@ void Hero::levelUpRefresh(Monsters& allMonsters)
       break;
     }
     // Random negative effect
-    switch (std::uniform_int_distribution<>(0, 2)(generator))
+    switch (std::uniform_int_distribution<>(0, 2)(randomGenerator()))
     {
     case 0:
       add(HeroDebuff::Poisoned, allMonsters);
@@ -1041,7 +1033,7 @@ bool Hero::petrifyPlant(Monsters& allMonsters)
 void Hero::rerollDodgeNext()
 {
   std::uniform_int_distribution<unsigned> number(1, 100);
-  dodgeNext = getDodgeChancePercent() >= number(generator);
+  dodgeNext = getDodgeChancePercent() >= number(randomGenerator());
 }
 
 void Hero::applyDragonSoul(unsigned manaCosts)
@@ -1049,7 +1041,7 @@ void Hero::applyDragonSoul(unsigned manaCosts)
   if (has(HeroStatus::Pessimist))
     return;
   std::uniform_int_distribution<> number(1, 100);
-  if (number(generator) <= 15)
+  if (number(randomGenerator()) <= 15)
     recoverManaPoints(manaCosts);
 }
 
@@ -1083,7 +1075,7 @@ bool Hero::spendGold(unsigned amountSpent)
 
 void Hero::collectGoldPile()
 {
-  unsigned amount = std::uniform_int_distribution<unsigned>(1, 3)(generator);
+  unsigned amount = std::uniform_int_distribution<unsigned>(1, 3)(randomGenerator());
   if (has(HeroTrait::BlackMarket))
     ++amount;
   inventory.gold += amount;
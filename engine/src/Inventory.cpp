@@ -223,15 +223,28 @@ int Inventory::sellingPrice(ItemOrSpell itemOrSpell) const
 unsigned Inventory::numFreeSmallSlots() const
 {
   const auto numSmallSlots = numSlots * LargeItemSize;
-  auto roomTaken = getSpells().size() * (spellsSmall ? 1 : LargeItemSize);
-  for (const auto& [entry, _] : getItemsGrouped())
-    roomTaken += entry.isSmall ? 1 : LargeItemSize;
+  // Same as counting getSpells() and getItemsGrouped(), without building the lists
+  unsigned roomTaken = 0;
+  for (auto entry = begin(entries); entry != end(entries); ++entry)
+  {
+    const auto item = std::get_if<Item>(&entry->itemOrSpell);
+    if (!item)
+    {
+      roomTaken += spellsSmall ? 1 : LargeItemSize;
+      continue;
+    }
+    // Potions of the same kind are grouped and take the room of the first one
+    if (std::holds_alternative<Potion>(*item) &&
+        std::any_of(begin(entries), entry, [&](const Entry& other) { return other.itemOrSpell == entry->itemOrSpell; }))
+      continue;
+    roomTaken += entry->isSmall ? 1 : LargeItemSize;
+  }
   if (roomTaken > numSmallSlots)
   {
     assert(false);
     return 0u;
   }
-  return numSmallSlots - static_cast<unsigned>(roomTaken);
+  return numSmallSlots - roomTaken;
 }
 
 bool Inventory::hasRoomFor(ItemOrSpell itemOrSpell) const
@@ -1,10 +1,12 @@
 #include "engine/Jehora.hpp"
 
 #include "engine/Hero.hpp"
+#include "engine/Random.hpp"
+
+#include <random>
 
 Jehora::Jehora()
-  : generator(std::random_device{}())
-  , happiness(14)
+  : happiness(14)
   , thresholdPoison(0)
   , thresholdManaBurn(1)
   , thresholdHealthLoss(1)
@@ -22,7 +24,7 @@ unsigned Jehora::initialPietyBonus(unsigned heroLevel, bool isPessimist)
   if (!isPessimist)
   {
     std::uniform_int_distribution<unsigned> initialBonus(70, 100);
-    multiplier = initialBonus(generator);
+    multiplier = initialBonus(randomGenerator());
   }
   else
     multiplier = 70;
@@ -40,10 +42,10 @@ unsigned Jehora::operator()()
   // Randomly award 2-4 XP or apply random punishment
   std::uniform_int_distribution<unsigned> happinessRoll(1, 15);
   std::uniform_int_distribution<unsigned> pietyRoll(2, 4);
-  if (happinessRoll(generator) <= happiness)
+  if (happinessRoll(randomGenerator()) <= happiness)
   {
     happiness = std::max(happiness - 1, 5u);
-    return pietyRoll(generator);
+    return pietyRoll(randomGenerator());
   }
   // a punishment is to be applied
   happiness = std::min(happiness + 1, 14u);
@@ -62,7 +64,7 @@ void Jehora::applyRandomPunishment(Hero& hero)
   unsigned rerolls = 0;
   while (true)
   {
-    const int roll = punishmentRoll(generator);
+    const int roll = punishmentRoll(randomGenerator());
     const int category = roll / 3;
     switch (category)
     {
@@ -6,10 +6,26 @@
 
 #include <algorithm>
 #include <cstdint>
+#include <mutex>
 #include <random>
+#include <type_traits>
+#include <unordered_set>
 #include <utility>
 
-int Monster::lastId = 0;
+static_assert(std::is_trivially_copyable_v<Monster>);
+
+std::atomic<int> Monster::lastId{0};
+
+namespace
+{
+  const std::string* internName(std::string name)
+  {
+    static std::mutex mutex;
+    static std::unordered_set<std::string> names;
+    std::scoped_lock lock(mutex);
+    return &*names.insert(std::move(name)).first;
+  }
+} // namespace
 
 std::string Monster::makeName(MonsterType type, Level level)
 {
@@ -18,8 +34,8 @@ std::string Monster::makeName(MonsterType type, Level level)
 }
 
 Monster::Monster(MonsterType type, Level level, DungeonMultiplier dungeonMultiplier)
-  : name(makeName(type, level))
-  , id(++lastId)
+  : name(internName(makeName(type, level)))
+  , id(lastId.fetch_add(1, std::memory_order_relaxed) + 1)
   , stats(type, level, dungeonMultiplier)
   , defence(type)
   , traits(type)
@@ -27,8 +43,8 @@ Monster::Monster(MonsterType type, Level level, DungeonMultiplier dungeonMultipl
 }
 
 Monster::Monster(std::string name, MonsterStats stats, Defence damage, MonsterTraits traits)
-  : name(std::move(name))
-  , id(++lastId)
+  : name(internName(std::move(name)))
+  , id(lastId.fetch_add(1, std::memory_order_relaxed) + 1)
   , stats(std::move(stats))
   , defence(std::move(damage))
   , status{}
@@ -46,7 +62,7 @@ Monster::Monster(MonsterStats stats, Defence defence, MonsterTraits traits)
 
 const std::string& Monster::getName() const
 {
-  return name;
+  return *name;
 }
 
 int Monster::getID() const
@@ -251,11 +267,11 @@ void Monster::makeWickedSick()
   if (!isWickedSick() && level.increase())
   {
     const auto type = stats.getType();
-    const bool hasStandardName = name == makeName(type, level);
+    const bool hasStandardName = *name == makeName(type, level);
     traits.addWickedSick();
     stats = MonsterStats(stats.getType(), level, stats.getDungeonMultiplier());
     if (hasStandardName)
-      name = makeName(type, level);
+      name = internName(makeName(type, level));
   }
 }
 
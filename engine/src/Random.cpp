@@ -0,0 +1,23 @@
+#include "engine/Random.hpp"
+
+#include <random>
+
+namespace
+{
+  std::uint64_t randomSeed()
+  {
+    std::random_device device;
+    return (static_cast<std::uint64_t>(device()) << 32) | device();
+  }
+} // namespace
+
+RandomGenerator& randomGenerator()
+{
+  thread_local RandomGenerator generator{randomSeed()};
+  return generator;
+}
+
+void seedRandomGenerator(std::uint64_t seed)
+{
+  randomGenerator() = RandomGenerator{seed};
+}
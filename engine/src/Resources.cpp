@@ -7,6 +7,7 @@
 #include <algorithm>
 #include <cassert>
 #include <functional>
+#include <random>
 
 ResourceSet::ResourceSet(const DungeonSetup& setup)
   : numWalls{setup.mapSize * setup.mapSize * 4 * (setup.altar == GodOrPactmaker{God::BinlorIronshield} ? 7u : 10u) /
@@ -53,7 +54,7 @@ bool ResourceSet::pactmakerAvailable() const
   return std::find(begin(altars), end(altars), GodOrPactmaker{Pactmaker::ThePactmaker}) != end(altars);
 }
 
-void ResourceSet::addRandomShop(std::mt19937 generator)
+void ResourceSet::addRandomShop(RandomGenerator& generator)
 {
   const int n = static_cast<int>(ShopItem::Last);
   if (shops.size() > n)
@@ -66,7 +67,7 @@ void ResourceSet::addRandomShop(std::mt19937 generator)
   shops.emplace_back(item);
 }
 
-void ResourceSet::addRandomSpell(std::mt19937 generator)
+void ResourceSet::addRandomSpell(RandomGenerator& generator)
 {
   const int n = static_cast<int>(Spell::Last);
   if (spells.size() > n)
@@ -79,7 +80,7 @@ void ResourceSet::addRandomSpell(std::mt19937 generator)
   spells.emplace_back(spell);
 }
 
-void ResourceSet::addRandomAltar(std::mt19937 generator)
+void ResourceSet::addRandomAltar(RandomGenerator& generator)
 {
   const unsigned n = static_cast<int>(God::Last) + 1;
   if (altars.size() > n)
@@ -98,7 +99,7 @@ void ResourceSet::addRandomAltar(std::mt19937 generator)
 
 void ResourceSet::addRandomResources(int numShops, int numSpells, int numAltars)
 {
-  std::mt19937 generator{std::random_device{}()};
+  auto& generator = randomGenerator();
   for (int i = 0; i < numShops; ++i)
     addRandomShop(generator);
   for (int i = 0; i < numSpells; ++i)
@@ -227,6 +228,7 @@ void MapResources::revealTile()
   // for n - numWalls - numGoldPiles < numShops -> reveal a shop
   // ...
   // numOfAllResources <= n < numHiddenTiles -> reveal nothing
+  auto& generator = randomGenerator();
   auto n = rand(generator);
   bool revealedWall = true;
   for (const auto& [count, reveal] : resourceCountsAndReveals)
@@ -2,10 +2,10 @@
 
 #include "engine/DungeonSetup.hpp"
 #include "engine/GodsAndBoons.hpp"
+#include "engine/Random.hpp"
 #include "engine/Resources.hpp"
 #include "engine/Spells.hpp"
 
-#include <random>
 #include <set>
 
 using namespace bandit;
@@ -19,6 +19,13 @@ void testResources()
       ResourceSet resourceSet2{DungeonSetup{}};
       AssertThat(resourceSet, !Equals(resourceSet2));
     });
+    it("shall be reproducible using a fixed seed", [] {
+      seedRandomGenerator(42);
+      ResourceSet resourceSet1{DungeonSetup{}};
+      seedRandomGenerator(42);
+      ResourceSet resourceSet2{DungeonSetup{}};
+      AssertThat(resourceSet1, Equals(resourceSet2));
+    });
     it("shall have 3 different altars", [&altars = resourceSet.altars] {
       AssertThat(altars.size(), Equals(3u));
       AssertThat(std::set(begin(altars), end(altars)).size(), Equals(3u));
@@ -33,13 +40,12 @@ void testResources()
     });
     it("shall have Burndayraz", [&spells = resourceSet.spells] { AssertThat(spells, Contains(Spell::Burndayraz)); });
     it("shall avoid duplicate resources", [] {
-      std::mt19937 generator{std::random_device{}()};
       ResourceSet lotsOf;
       for (int i = 0; i < 100; ++i)
       {
-        lotsOf.addRandomAltar(generator);
-        lotsOf.addRandomSpell(generator);
-        lotsOf.addRandomShop(generator);
+        lotsOf.addRandomAltar();
+        lotsOf.addRandomSpell();
+        lotsOf.addRandomShop();
       }
       AssertThat(lotsOf.altars.size(), Equals((unsigned)God::Last + 2));
       AssertThat(lotsOf.spells.size(), Equals((unsigned)Spell::Last + 1));
@@ -0,0 +1,102 @@
+#pragma once
+
+#include "engine/Random.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace benchmark
+{
+  struct Result
+  {
+    std::string name;
+    std::uint64_t iterations{0};
+    double nsPerOp{0};
+    double allocationsPerOp{0};
+  };
+
+  struct Benchmark
+  {
+    std::string name;
+    std::function<Result()> run;
+  };
+
+  struct Settings
+  {
+    //! Minimum time spent in the measured operation per batch; the reported time is the median over all batches
+    std::chrono::milliseconds minBatchTime{50};
+    unsigned numBatches{5};
+    //! Number of fixtures prepared at once, outside of the timed region
+    std::size_t chunkSize{256};
+    //! The random generator is re-seeded before each benchmark, so that random events are repeatable
+    std::uint64_t seed{42};
+  };
+
+  //! Number of heap allocations made by the process so far.  Counted by a replacement of the global operator new,
+  //! which is part of the benchmark executables only.
+  std::uint64_t numAllocations();
+
+  //! Prevent the compiler from optimising away the computation of `value`
+  void keep(const void* value);
+
+  template <class T>
+  void keep(const T& value)
+  {
+    keep(static_cast<const void*>(&value));
+  }
+
+  /** @brief Time `operation(fixture)`, where the fixtures are created by `setup(index)` outside of the timed region.
+   *  Setup may return a reference wrapper to measure operations on shared, unmodified fixtures.
+   **/
+  template <class Setup, class Operation>
+  Result measure(Setup setup, Operation operation, const Settings& settings = {})
+  {
+    using Clock = std::chrono::steady_clock;
+    seedRandomGenerator(settings.seed);
+    Result result;
+    std::uint64_t numAllocated = 0;
+    std::vector<double> batchNsPerOp;
+    std::size_t index = 0;
+    for (unsigned batch = 0; batch < settings.numBatches; ++batch)
+    {
+      Clock::duration elapsed{0};
+      std::uint64_t numOps = 0;
+      while (elapsed < settings.minBatchTime)
+      {
+        std::vector<decltype(setup(index))> fixtures;
+        fixtures.reserve(settings.chunkSize);
+        for (std::size_t i = 0; i < settings.chunkSize; ++i)
+          fixtures.emplace_back(setup(index++));
+        const auto allocationsBefore = numAllocations();
+        const auto start = Clock::now();
+        for (auto& fixture : fixtures)
+          operation(fixture);
+        elapsed += Clock::now() - start;
+        numAllocated += numAllocations() - allocationsBefore;
+        numOps += fixtures.size();
+      }
+      batchNsPerOp.push_back(std::chrono::duration<double, std::nano>(elapsed).count() / static_cast<double>(numOps));
+      result.iterations += numOps;
+    }
+    std::nth_element(begin(batchNsPerOp), begin(batchNsPerOp) + batchNsPerOp.size() / 2, end(batchNsPerOp));
+    result.nsPerOp = batchNsPerOp[batchNsPerOp.size() / 2];
+    result.allocationsPerOp = static_cast<double>(numAllocated) / static_cast<double>(result.iterations);
+    return result;
+  }
+
+  void save(const std::vector<Result>& results, const std::string& path);
+  std::vector<Result> load(const std::string& path);
+
+  //! Print results as a table, with the relative change to the baseline results of the same name (if any)
+  void print(const std::vector<Result>& results, const std::vector<Result>& baseline);
+
+  /** @brief Command line entry point of the benchmark executables.
+   *  Options: --filter <text> (only run benchmarks whose name contains the text), --save <file> (write results as
+   *  JSON), --compare <file> (show changes relative to a previously saved baseline).
+   **/
+  int main(int argc, char* argv[], const std::vector<Benchmark>& benchmarks);
+} // namespace benchmark
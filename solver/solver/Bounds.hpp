@@ -0,0 +1,42 @@
+#pragma once
+
+#include "solver/GameState.hpp"
+
+#include <optional>
+#include <span>
+#include <vector>
+
+namespace solver
+{
+  //! Items on sale or on the ground that would make the hero stronger if received for free
+  std::vector<Item> helpfulItems(const GameState& state);
+
+  /** @brief Heuristic estimates of what can still be achieved from a game state, used to cut the tree search.
+   *  The estimates assume that the hero gains the experience of all visible monsters with every bonus, recovers on
+   *  all hidden tiles, and receives the helpful items still available for free.  Effects that are not modelled this
+   *  way (piety, overhealing, temporary damage bonuses, ...) are covered by slack that is generous but not derived
+   *  from the game rules.  The estimates are therefore not guaranteed bounds, and a search cut by them may miss the
+   *  best line.
+   **/
+  class HeuristicBounds
+  {
+  public:
+    explicit HeuristicBounds(const GameState& state);
+    //! Only consider the given items, as found by helpfulItems() for an earlier state, to spare the search the effort
+    HeuristicBounds(const GameState& state, std::span<const Item> helpfulItems);
+
+    //! Estimated maximum of StateFitnessRating1 for any non-winning state reachable from the state
+    int fitness() const { return maxFitness; }
+
+    //! Estimated minimum number of steps needed to defeat all visible monsters.  Nullopt if the game is lost, or if
+    //! the hero cannot damage a monster without help that is not modelled.
+    std::optional<unsigned> stepsToWin() const { return minStepsToWin; }
+
+    //! Estimated maximum of StateFitnessRating1 for any state reachable within the given number of steps
+    int within(unsigned numSteps) const;
+
+  private:
+    int maxFitness;
+    std::optional<unsigned> minStepsToWin;
+  };
+} // namespace solver
@@ -0,0 +1,66 @@
+#pragma once
+
+#include "solver/GameState.hpp"
+
+#include <array>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+namespace solver
+{
+  /** @brief Quantities in which a state can be better than an otherwise identical one.
+   *  More mana points, gold or hidden tiles are assumed never to hurt the hero.  So are more hit points, unless the
+   *  hero benefits from low health (Determined, Halpmeh); those states must then have equal hit points.
+   **/
+  struct Quantities
+  {
+    std::uint16_t hitPoints{0};
+    std::uint16_t manaPoints{0};
+    unsigned gold{0};
+    unsigned hiddenTiles{0};
+    bool moreHitPointsNeverHurt{true};
+
+    explicit Quantities(const GameState& state);
+    Quantities() = default;
+
+    //! At least as good in every quantity, and better in at least one
+    bool dominates(const Quantities& other) const;
+    bool operator==(const Quantities&) const = default;
+  };
+
+  /** @brief Bounded, thread-safe record of the states searched in an iteration of the tree search.
+   *  States are identified by hash(state) ^ quantityHash(state) (@see StateHash.hpp), i.e. regardless of their
+   *  quantities.  A state is dominated if a state with the same identity and dominating quantities has been recorded
+   *  with at least the same remaining search depth; it cannot lead to a better line and need not be expanded.
+   **/
+  class DominanceStore
+  {
+  public:
+    explicit DominanceStore(std::size_t numBuckets = 1u << 16);
+
+    //! Return true if the state is dominated, otherwise record it
+    bool dominatedOrInsert(std::uint64_t identity, const Quantities& quantities, int depth);
+    //! Forget all states in constant time; must not be called concurrently with dominatedOrInsert
+    void clear() { ++generation; }
+
+  private:
+    struct Entry
+    {
+      std::uint64_t identity{0};
+      Quantities quantities{};
+      int depth{-1};
+      unsigned generation{0};
+    };
+    static constexpr std::size_t BucketSize = 4;
+    using Bucket = std::array<Entry, BucketSize>;
+
+    std::vector<Bucket> buckets;
+    // Entries of earlier generations are treated as empty
+    unsigned generation{1};
+    mutable std::array<std::mutex, 64> locks;
+
+    std::size_t index(std::uint64_t identity) const { return identity & (buckets.size() - 1); }
+    std::mutex& lockFor(std::size_t index) const { return locks[index % locks.size()]; }
+  };
+} // namespace solver
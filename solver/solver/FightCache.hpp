@@ -0,0 +1,52 @@
+#pragma once
+
+#include "solver/Heuristics.hpp"
+
+#include "engine/Hero.hpp"
+#include "engine/Monster.hpp"
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+namespace solver
+{
+  /** @brief Bounded, thread-safe memo of melee fight predictions (@see heuristics::predictMelee).
+   *  Fights that the predictor has to simulate are stored, indexed by the hashes of hero and monster (@see
+   *  StateHash.hpp) extended by the hero's traits and the monster's trait parameters, since a simulated fight may
+   *  depend on any of them; colliding entries are replaced.
+   *  Fights with the same exchange of damage in every attack (@see heuristics::isStationaryFight) are mostly computed
+   *  in closed form, which is cheaper than a lookup, so they are passed through without being stored.
+   **/
+  class FightCache
+  {
+  public:
+    explicit FightCache(std::size_t numEntries = 1u << 14);
+
+    heuristics::MeleeResult predictMelee(const Hero& hero, const Monster& monster);
+    void clear();
+
+    //! Number of predictions answered from the cache
+    std::uint64_t getNumHits() const { return numHits; }
+
+  private:
+    struct Entry
+    {
+      std::uint64_t heroHash{0};
+      std::uint64_t monsterHash{0};
+      heuristics::MeleeResult result{};
+    };
+
+    std::vector<Entry> entries;
+    mutable std::array<std::mutex, 64> locks;
+    std::atomic<std::uint64_t> numHits{0};
+
+    std::size_t index(std::uint64_t heroHash, std::uint64_t monsterHash) const;
+    std::mutex& lockFor(std::size_t index) const { return locks[index % locks.size()]; }
+  };
+
+  //! Cache shared by the heuristics and the UI
+  FightCache& sharedFightCache();
+} // namespace solver
@@ -20,6 +20,15 @@ class StateFitnessRating1 : public StateFitnessRating
     std::string explain(const GameState&) const override final;
 };
 
+//! Components of StateFitnessRating1; the rating is hero + inventory + resources - monsters
+namespace fitness1
+{
+  unsigned computeInventoryScore(const Hero& hero);
+  unsigned computeResourceScore(const SimpleResources& resources);
+  unsigned computeHeroScore(const Hero& hero);
+  unsigned computeMonsterScore(const Monsters& monsters);
+} // namespace fitness1
+
 class StateFitnessRating2 : public StateFitnessRating
 {
   public:
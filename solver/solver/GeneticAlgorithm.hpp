@@ -0,0 +1,28 @@
+#pragma once
+
+#include "solver/GameState.hpp"
+#include "solver/Solution.hpp"
+#include "solver/SolverControl.hpp"
+
+#include <optional>
+
+//! Parameters of the genetic algorithm solver
+struct GeneticAlgorithmSettings
+{
+  unsigned numGenerations{100};
+  //! Total number of candidates, split evenly across the islands
+  unsigned populationSize{1000};
+  //! Number of independently evolving sub-populations; 0 means one per hardware thread.  Limited such that every
+  //! island has at least 50 candidates.
+  unsigned numIslands{0};
+  //! Number of generations between migrations of the best candidates to the next island
+  unsigned migrationInterval{5};
+};
+
+/** @brief Solve using a genetic algorithm.
+ *  With several islands, each one evolves on its own thread with its own selection and temperature schedule; the
+ *  islands only synchronise for migration.  A single island evaluates its candidates in parallel instead.
+ *  Returns the best solution found, which does not necessarily win the game.
+ **/
+std::optional<Solution>
+runGeneticAlgorithm(GameState state, SolverControl& control, const GeneticAlgorithmSettings& settings = {});
@@ -46,8 +46,35 @@ namespace heuristics
    **/
   CatapultResult checkLevelCatapult(const Hero& hero, const Monsters& monsters);
 
-  //! Return true if hero can defeat monster by attacking (repeatedly)
-  bool checkMeleeOnly(Hero hero, Monster monster);
+  //! Outcome of attacking a monster repeatedly, without recovering or taking any other steps in between
+  struct MeleeResult
+  {
+    //! Number of attacks until the monster or the hero is defeated
+    unsigned numAttacks{0};
+    //! Number of times the monster strikes the hero
+    unsigned numHitsTaken{0};
+    unsigned heroHitPoints{0};
+    unsigned monsterHitPoints{0};
+    bool heroDeathProtectionUsed{false};
+    unsigned monsterDeathProtectionUsed{0};
+    bool heroWins{false};
+  };
+
+  /** @brief Predict a melee-only fight, assuming that the hero never dodges.
+   *  The hero's values are those after the final attack, including its effects such as a level up for defeating the
+   *  monster.  If hero and monster exchange the same damage in every attack and defeating the monster does not level
+   *  up the hero, the outcome is computed in closed form, without copying either of them.  Otherwise, e.g. for
+   *  burning or enraged monsters, or one-time attack effects of the hero, the fight is simulated.
+   *  If neither can defeat the other, the result has no attacks and the hero does not win.
+   **/
+  MeleeResult predictMelee(const Hero& hero, const Monster& monster);
+
+  //! True if hero and monster exchange the same damage in every attack, i.e. predictMelee does not simulate the fight
+  //! unless defeating the monster levels up the hero
+  bool isStationaryFight(const Hero& hero, const Monster& monster);
+
+  //! Return true if hero can defeat monster by attacking (repeatedly); simulated fights are cached (@see FightCache)
+  bool checkMeleeOnly(const Hero& hero, const Monster& monster);
 
   struct RegenFightResult
   {
@@ -0,0 +1,32 @@
+#pragma once
+
+#include "solver/GameState.hpp"
+#include "solver/Solution.hpp"
+#include "solver/SolverControl.hpp"
+
+#include <chrono>
+#include <optional>
+
+//! Budget and tuning parameters of the Monte Carlo tree search solver
+struct MonteCarloSettings
+{
+  //! Number of iterations (selection, expansion, playout, backpropagation) spent before committing to a step
+  unsigned iterationsPerStep{10000};
+  //! Wall-clock limit for the whole search
+  std::chrono::milliseconds timeBudget{std::chrono::seconds{30}};
+  //! Number of independent trees grown in parallel (root parallelisation); 0 means one per hardware thread
+  unsigned numThreads{0};
+  //! Maximum number of random steps in a single playout
+  unsigned maxPlayoutLength{60};
+  //! UCT exploration constant
+  double exploration{0.7};
+};
+
+/** @brief Solve using Monte Carlo tree search (UCT with random playouts).
+ *  Steps are committed one at a time, each after a search from the current state.  The search ends as soon as a
+ *  playout wins the game.  If a budget runs out or the run is cancelled first, the steps committed so far are
+ *  returned.
+ *  Returns nullopt if the committed steps lead to the hero's defeat.
+ **/
+std::optional<Solution>
+runMonteCarloTreeSearch(GameState state, SolverControl& control, const MonteCarloSettings& settings = {});
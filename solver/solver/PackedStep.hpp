@@ -0,0 +1,32 @@
+#pragma once
+
+#include "solver/Solution.hpp"
+
+#include <cstdint>
+#include <vector>
+
+/** @brief Lossless 16-bit encoding of a Step.
+ *  The upper 4 bits hold the step type (the index into the Step variant), the lower 12 bits its operand, e.g. the
+ *  spell, the number of tiles or the item (variant index and enum value).
+ *  Packed steps are trivially copyable, so packed solutions can be copied and spliced as plain memory.
+ **/
+class PackedStep
+{
+public:
+  //! Default constructed packed step represents Attack, like a default constructed Step
+  PackedStep() = default;
+  PackedStep(const Step& step);
+
+  Step unpack() const;
+  std::uint16_t raw() const { return bits; }
+
+  friend bool operator==(PackedStep, PackedStep) = default;
+
+private:
+  std::uint16_t bits{0};
+};
+
+using PackedSolution = std::vector<PackedStep>;
+
+PackedSolution pack(const Solution& solution);
+Solution unpack(const PackedSolution& packedSolution);
@@ -1,5 +1,7 @@
 #pragma once
 
+#include "solver/GameState.hpp"
+
 #include "engine/Hero.hpp"
 #include "engine/Monster.hpp"
 #include "engine/Resources.hpp"
@@ -15,9 +17,35 @@ enum class Scenario
   TheMonsterMachine1,
   TheMonsterMachine2,
   TrueGrit,
+  Last = TrueGrit
 };
 
+constexpr const char* toString(Scenario scenario)
+{
+  switch (scenario)
+  {
+  case Scenario::AgbaarsAcademySlowingPart2:
+    return "Agbaar's Academy: Slowing Part 2";
+  case Scenario::HalflingTrial:
+    return "Halfling Trial";
+  case Scenario::TheThirdAct:
+    return "The Third Act";
+  case Scenario::TheMonsterMachine1:
+    return "The Monster Machine 2.1";
+  case Scenario::TheMonsterMachine2:
+    return "The Monster Machine 2.2";
+  case Scenario::TrueGrit:
+    return "True Grit";
+  }
+}
+
 Hero getHeroForScenario(Scenario scenario);
 std::vector<Monster> getMonstersForScenario(Scenario scenario);
 
 SimpleResources getResourcesForScenario(Scenario scenario);
+
+//! Initial state of the scenario; its monsters are generated randomly
+GameState initialState(Scenario scenario);
+
+//! Fighter versus a level 1 Goblin and Zombie, with 20 hidden tiles to recover on
+GameState simpleFight();
@@ -17,6 +17,7 @@ struct Cast
   Spell spell;
 };
 
+//! Uncover several tiles at once, e.g. as many as needed to fully recover
 struct Uncover
 {
   unsigned numTiles;
@@ -71,7 +72,12 @@ struct NoOp
 {
 };
 
-using Step = std::variant<Attack, Cast, Uncover, Buy, Use, Convert, Find, FindFree, Follow, Request, Desecrate, ChangeTarget, NoOp>;
+//! Macro step: attack until the monster is defeated or the next attack would defeat the hero (@see expandMacros)
+struct Fight
+{
+};
+
+using Step = std::variant<Attack, Cast, Uncover, Buy, Use, Convert, Find, FindFree, Follow, Request, Desecrate, ChangeTarget, NoOp, Fight>;
 
 using Solution = std::vector<Step>;
 
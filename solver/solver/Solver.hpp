@@ -2,6 +2,7 @@
 
 #include "solver/GameState.hpp"
 #include "solver/Solution.hpp"
+#include "solver/SolverControl.hpp"
 
 #include <optional>
 
@@ -10,10 +11,15 @@ enum class Solver
   GeneticAlgorithm,
   TreeSearch,
   Heuristics,
-  Last = Heuristics
+  MonteCarloTreeSearch,
+  //! Runs all other solvers concurrently and returns the first winning solution
+  Portfolio,
+  Last = Portfolio
 };
 
-std::optional<Solution> run(Solver solver, GameState initialState);
+std::optional<Solution> run(Solver solver, GameState initialState, SolverOptions options = {});
+//! Run with a control owned by the caller, e.g. to query the number of evaluated nodes afterwards
+std::optional<Solution> run(Solver solver, GameState initialState, SolverControl& control);
 
 constexpr const char* toString(Solver solver)
 {
@@ -25,5 +31,9 @@ constexpr const char* toString(Solver solver)
     return "Tree Search";
   case Solver::Heuristics:
     return "Heuristics";
+  case Solver::MonteCarloTreeSearch:
+    return "Monte Carlo Tree Search";
+  case Solver::Portfolio:
+    return "Portfolio";
   }
 }
@@ -0,0 +1,118 @@
+#pragma once
+
+#include "solver/SolverTrace.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <stop_token>
+
+//! Progress of a running solver, see SolverOptions::onProgress
+struct SolverProgress
+{
+  //! Generation (genetic algorithm) or number of steps committed so far (tree search, Monte Carlo tree search)
+  unsigned iteration{0};
+  int bestScore{0};
+  //! Search depth reached before the last commit (tree search only)
+  unsigned depth{0};
+  std::uint64_t numNodes{0};
+  double nodesPerSecond{0};
+};
+
+//! Events counted by the solvers.  Accumulated locally (e.g. per candidate or per batch of iterations) and added to
+//! the SolverControl in one go, to keep contention on the shared counters low.
+struct SolverCounts
+{
+  std::uint64_t statesApplied{0};
+  //! Steps of a candidate solution that were dropped because they are not possible in the state reached
+  std::uint64_t invalidSteps{0};
+  //! Lookups in the genetic algorithm's prefix cache or the tree search's transposition table
+  std::uint64_t cacheHits{0};
+  std::uint64_t cacheMisses{0};
+};
+
+//! Snapshot of the counters of a solver run, see SolverControl::getMetrics
+struct SolverMetrics
+{
+  SolverCounts counts;
+  std::uint64_t numNodes{0};
+  double elapsedSeconds{0};
+  //! Wall time of the most recent and of the slowest iteration (see SolverProgress::iteration)
+  double lastIterationSeconds{0};
+  double maxIterationSeconds{0};
+  //! Peak resident memory of the process; 0 where this is not available (Windows)
+  std::uint64_t peakMemoryBytes{0};
+};
+
+//! Budgets, cancellation and progress reporting of a solver run
+struct SolverOptions
+{
+  //! Solvers return their best result so far once a stop is requested or a budget is exhausted
+  std::stop_token stopToken{};
+  std::optional<std::chrono::milliseconds> timeBudget{};
+  //! Maximum number of game states to evaluate
+  std::optional<std::uint64_t> nodeBudget{};
+  //! Called from the solver's thread after each generation, search or committed step
+  std::function<void(const SolverProgress&)> onProgress{};
+  //! Number of worker threads (islands of the genetic algorithm, trees of the Monte Carlo tree search, parallel
+  //! branches of the tree search); 0 means one per hardware thread
+  unsigned numThreads{0};
+  //! Seed for reproducible runs; by default, random generators are seeded randomly
+  std::optional<std::uint64_t> seed{};
+  //! Receives diagnostic events such as the best candidate of each generation; no tracing by default
+  std::shared_ptr<TraceSink> traceSink{};
+};
+
+//! Used by the solver implementations to count evaluated nodes and other events, check budgets and report progress
+class SolverControl
+{
+public:
+  explicit SolverControl(SolverOptions options = {});
+
+  //! Check for cancellation and exhausted budgets.  Thread-safe.
+  bool shouldStop() const;
+  //! Count evaluated game states.  Thread-safe.
+  void addNodes(std::uint64_t numAdded) { numNodes.fetch_add(numAdded, std::memory_order_relaxed); }
+  std::uint64_t getNumNodes() const { return numNodes.load(std::memory_order_relaxed); }
+  //! Add event counts.  Thread-safe.
+  void add(const SolverCounts& counts);
+  //! Current state of all counters.  Thread-safe, may be called while the solver is running.
+  SolverMetrics getMetrics() const;
+  //! Invoke the progress callback, if any.  Also marks the end of an iteration for the timings in SolverMetrics.
+  void report(unsigned iteration, int bestScore, unsigned depth = 0);
+
+  //! Pass the event returned by `makeEvent()` to the trace sink.  `makeEvent` is not called if there is no sink.
+  template <class MakeEvent>
+  void trace(MakeEvent makeEvent) const
+  {
+    if (!options.traceSink)
+      return;
+    TraceEvent event = makeEvent();
+    event.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    options.traceSink->write(event);
+  }
+
+  unsigned getNumThreads() const { return options.numThreads; }
+  //! Options for a solver that runs on behalf of this one (e.g. within a portfolio): same threads, seed and trace
+  //! sink, but stopped by `stopToken`.  Budgets and progress reports remain with this control.
+  SolverOptions subordinateOptions(std::stop_token stopToken) const;
+  //! If a seed was given, re-seed the calling thread's random generator for the unit of work identified by `stream`
+  //! (e.g. a candidate of a generation).  Results then do not depend on which thread executes the work.
+  void reseed(std::uint64_t stream) const;
+
+private:
+  SolverOptions options;
+  std::chrono::steady_clock::time_point start;
+  std::atomic<std::uint64_t> numNodes{0};
+  std::atomic<std::uint64_t> statesApplied{0};
+  std::atomic<std::uint64_t> invalidSteps{0};
+  std::atomic<std::uint64_t> cacheHits{0};
+  std::atomic<std::uint64_t> cacheMisses{0};
+  // Iteration timings, written by report() only
+  std::chrono::steady_clock::time_point lastReport;
+  std::atomic<std::int64_t> lastIterationNs{0};
+  std::atomic<std::int64_t> maxIterationNs{0};
+};
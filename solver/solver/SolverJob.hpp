@@ -0,0 +1,43 @@
+#pragma once
+
+#include "solver/GameState.hpp"
+#include "solver/Solution.hpp"
+#include "solver/Solver.hpp"
+#include "solver/SolverControl.hpp"
+
+#include <atomic>
+#include <mutex>
+#include <optional>
+#include <stop_token>
+#include <thread>
+
+/** @brief Runs a solver on a background thread.
+ *  The job's own stop token replaces SolverOptions::stopToken; use cancel() to stop the solver early.
+ *  Destroying a job cancels it and waits for the solver to return.
+ **/
+class SolverJob
+{
+public:
+  SolverJob(Solver solver, GameState initialState, SolverOptions options = {});
+  ~SolverJob();
+
+  void cancel();
+  bool isCancelled() const;
+  bool isDone() const;
+  //! Most recent progress report
+  SolverProgress getProgress() const;
+  //! Live counters of the solver
+  SolverMetrics getMetrics() const;
+  //! Result of the solver; only available once the job is done
+  std::optional<Solution> getResult() const;
+
+private:
+  std::stop_source stopSource;
+  SolverControl control;
+  mutable std::mutex mutex;
+  SolverProgress progress;
+  std::optional<Solution> result;
+  std::atomic<bool> done{false};
+  // Declared last: the thread has to be started after and joined before the other members are destroyed
+  std::jthread thread;
+};
@@ -1,16 +1,43 @@
 #include "solver/GameState.hpp"
 #include "solver/Solution.hpp"
 
+#include <optional>
+
 namespace solver
 {
-  Step generateValidStep(const GameState& state, bool allowTargetChange);
+  /** @brief Pre-images of those parts of a game state that a step applied in place may modify.
+   *  Only the components a step can actually touch are recorded, e.g. Buy and Find only store the hero and the index
+   *  of the removed resource, ChangeTarget only stores the previous target.
+   **/
+  struct UndoRecord
+  {
+    std::size_t activeMonster{0};
+    unsigned numHiddenTiles{0};
+    std::optional<Hero> hero{};
+    std::optional<Monsters> monsters{};
+    std::optional<SimpleResources> resources{};
+    // Position of the entry removed from shops, spells, free spells or altars (depending on the step type)
+    std::optional<std::size_t> removedIndex{};
+  };
+
   Step generateRandomValidStep(const GameState& state, bool allowTargetChange);
   std::vector<Step> generateAllValidSteps(const GameState& state, bool allowTargetChange);
 
   bool isValid(Step step, const GameState& state);
 
+  //! Whether a Fight attacks (once more): the target is alive and the attack is not predicted to defeat the hero
+  bool continuesFight(const GameState& state);
+  //! Replace macro steps by the primitive steps they perform when applied to `state`, e.g. Uncover{3} by three
+  //! Uncover{1} and Fight by its attacks
+  Solution expandMacros(const Solution& solution, GameState state);
+
   GameState apply(const Step& step, GameState state);
   GameState apply(const Solution& solution, GameState state);
 
+  //! Apply step to state in place and return information needed to revert it
+  [[nodiscard]] UndoRecord applyInPlace(const Step& step, GameState& state);
+  //! Revert a step applied using applyInPlace.  Multiple steps have to be reverted in reverse order.
+  void unapply(const Step& step, UndoRecord undo, GameState& state);
+
   void print(const Solution& solution, GameState state);
 } // namespace solver
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstddef>
+#include <deque>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <vector>
+
+//! Diagnostic record of a solver, e.g. the best candidate after a generation
+struct TraceEvent
+{
+  //! Kind of event, e.g. "generation" or "partial solution"
+  std::string type;
+  unsigned iteration{0};
+  int score{0};
+  //! Steps of the solution the event refers to, as by toString(Solution)
+  std::string solution{};
+  //! Solver specific information, free form
+  std::string details{};
+  //! Time since the solver was started
+  double seconds{0};
+};
+
+/** @brief Destination of trace events, see SolverOptions::traceSink.
+ *  Events are only created if a sink is set, so an untraced solver run does not format any output.
+ **/
+class TraceSink
+{
+public:
+  virtual ~TraceSink() = default;
+  //! May be called from any of the solver's threads
+  virtual void write(const TraceEvent& event) = 0;
+};
+
+//! Appends one JSON object per event to a file.  Output is buffered and only flushed when the sink is destroyed.
+class JsonLinesTraceSink : public TraceSink
+{
+public:
+  explicit JsonLinesTraceSink(const std::string& path);
+  void write(const TraceEvent& event) override;
+
+private:
+  std::mutex mutex;
+  std::ofstream out;
+};
+
+//! Keeps the most recent events in memory, e.g. for display in the UI
+class RingBufferTraceSink : public TraceSink
+{
+public:
+  explicit RingBufferTraceSink(std::size_t capacity = 100);
+  void write(const TraceEvent& event) override;
+  //! Copy of the stored events, oldest first
+  std::vector<TraceEvent> getEvents() const;
+
+private:
+  const std::size_t capacity;
+  mutable std::mutex mutex;
+  std::deque<TraceEvent> events;
+};
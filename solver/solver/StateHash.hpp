@@ -0,0 +1,26 @@
+#pragma once
+
+#include "solver/GameState.hpp"
+#include "solver/Solution.hpp"
+
+#include <cstdint>
+
+namespace solver
+{
+  /** @brief Compute a 64-bit Zobrist-style hash of a game state.
+   *  Every relevant feature (hero stats and statuses, inventory, visible monsters, resources) contributes a
+   *  pseudo-random key derived from the feature and its value; keys are combined by XOR (or by addition for unordered
+   *  collections), so that states reached by different step orders hash identically.
+   *  The piety history of the visible monsters is included by their position.  Some internal state (e.g. pending
+   *  dodge rolls or the counts some deities keep) is not included.
+   **/
+  std::uint64_t hash(const GameState& state);
+
+  //! Contribution of the hero's hit points, mana points and gold and of the hidden tiles to hash(state).
+  //! States that only differ in these quantities have the same hash(state) ^ quantityHash(state).
+  std::uint64_t quantityHash(const GameState& state);
+
+  std::uint64_t hash(const Hero& hero);
+  std::uint64_t hash(const Monster& monster);
+  std::uint64_t hash(const SimpleResources& resources);
+} // namespace solver
@@ -0,0 +1,44 @@
+#pragma once
+
+#include "solver/PackedStep.hpp"
+
+#include <array>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <vector>
+
+namespace solver
+{
+  /** @brief Bounded, thread-safe cache of search results, indexed by state hash (@see solver::hash).
+   *  Each slot stores the best score found for a state, the search depth that score was obtained with, and the first
+   *  step leading towards it.  Colliding entries are replaced unless the stored result was searched deeper.
+   **/
+  class TranspositionTable
+  {
+  public:
+    struct Entry
+    {
+      std::uint64_t hash{0};
+      int score{0};
+      int depth{-1};
+      PackedStep bestStep{NoOp{}};
+    };
+
+    explicit TranspositionTable(std::size_t numEntries = 1u << 18);
+
+    //! Return stored entry for the state, if it has been searched at least to the requested depth
+    std::optional<Entry> lookup(std::uint64_t hash, int minDepth) const;
+    void store(Entry entry);
+    void clear();
+
+    std::size_t size() const { return entries.size(); }
+
+  private:
+    std::vector<Entry> entries;
+    mutable std::array<std::mutex, 64> locks;
+
+    std::size_t index(std::uint64_t hash) const { return hash & (entries.size() - 1); }
+    std::mutex& lockFor(std::size_t index) const { return locks[index % locks.size()]; }
+  };
+} // namespace solver
@@ -0,0 +1,35 @@
+#pragma once
+
+#include "solver/GameState.hpp"
+#include "solver/Solution.hpp"
+#include "solver/SolverControl.hpp"
+
+#include <chrono>
+#include <optional>
+
+//! Budget parameters of the tree search solver
+struct TreeSearchSettings
+{
+  //! Deepest iteration of the iterative deepening before committing to steps
+  int maxDepth{12};
+  //! Wall-clock limit for the search before each commit; the deepest completed iteration is used
+  std::chrono::milliseconds timePerStep{std::chrono::seconds{5}};
+  //! Below the root, nodes with at least this remaining depth search their children in parallel (once the first
+  //! child has been searched).  Only applies if the solver may use more than one thread.
+  int minSplitDepth{3};
+  //! Cut branches whose heuristic bounds (@see solver::HeuristicBounds) do not exceed the best line.  The bounds are
+  //! not admissible, so the search may miss a better line.
+  bool heuristicCut{false};
+};
+
+/** @brief Solve using a depth-first tree search with iterative deepening, parallelised with work stealing.
+ *  From the current state, the search is repeated with increasing depth, trying the principal variation of the
+ *  previous iteration first, until a win is found, the maximum depth is reached or the time per step is up.  The
+ *  principal variation of the deepest completed iteration is committed, and the search continues from its final
+ *  state.  If the run is stopped or a budget is exhausted, the steps committed so far are returned, followed by the
+ *  best line found since.
+ *  Nodes with many steps only search the better rated ones; the other steps are not part of the search.
+ *  Returns nullopt if every line searched leads to the hero's defeat, as soon as that is proven.  If the lines found
+ *  only lose without such a proof, the steps committed so far are returned.
+ **/
+std::optional<Solution> runTreeSearch(GameState state, SolverControl& control, const TreeSearchSettings& settings = {});
@@ -0,0 +1,50 @@
+#pragma once
+
+#include "solver/GameState.hpp"
+#include "solver/PackedStep.hpp"
+
+#include <array>
+#include <cstdint>
+#include <variant>
+
+namespace solver
+{
+  /** @brief All valid steps of a game state, collected once into fixed-capacity storage (no heap allocations).
+   *  Steps are enumerated in the order of generateAllValidSteps.  Random steps are drawn like in the original
+   *  rejection sampling: first a step type, uniformly among the types with at least one valid step (boons and pacts
+   *  count as separate types), then a step of that type.
+   *  Target changes are offered once per kind of interchangeable monsters (same name, hash and piety history, see
+   *  StateHash.hpp), and not to monsters interchangeable with the current target.
+   *  Besides single steps, the macro steps Fight (if it would take more than one attack) and Uncover of as many tiles
+   *  as needed for full recovery are offered (@see expandMacros).
+   *  Throws std::length_error if a state has more valid steps than the capacity.
+   **/
+  class ValidSteps
+  {
+  public:
+    static constexpr std::size_t capacity = 256;
+
+    ValidSteps(const GameState& state, bool allowTargetChange);
+
+    std::size_t size() const { return numSteps; }
+    bool empty() const { return numSteps == 0; }
+    Step operator[](std::size_t index) const { return steps[index].unpack(); }
+
+    const PackedStep* begin() const { return steps.data(); }
+    const PackedStep* end() const { return steps.data() + numSteps; }
+
+    //! Draw a random step, or NoOp if there is no valid step
+    Step random() const;
+
+  private:
+    // One step type per alternative of Step, plus pacts, which are sampled separately from boons
+    static constexpr std::size_t numTypes = std::variant_size_v<Step> + 1;
+
+    void add(const Step& step);
+
+    std::array<PackedStep, capacity> steps;
+    std::array<std::uint8_t, capacity> types;
+    std::array<std::uint16_t, numTypes> typeCounts{};
+    std::size_t numSteps{0};
+  };
+} // namespace solver
@@ -0,0 +1,159 @@
+#include "solver/Benchmark.hpp"
+
+#include <atomic>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <sstream>
+
+namespace
+{
+  std::atomic<std::uint64_t> allocationCount{0};
+  const void* volatile sink{nullptr};
+} // namespace
+
+void* operator new(std::size_t size)
+{
+  allocationCount.fetch_add(1, std::memory_order_relaxed);
+  if (void* memory = std::malloc(size > 0 ? size : 1))
+    return memory;
+  throw std::bad_alloc{};
+}
+
+void operator delete(void* memory) noexcept
+{
+  std::free(memory);
+}
+
+void operator delete(void* memory, std::size_t) noexcept
+{
+  std::free(memory);
+}
+
+namespace benchmark
+{
+  std::uint64_t numAllocations()
+  {
+    return allocationCount.load(std::memory_order_relaxed);
+  }
+
+  void keep(const void* value)
+  {
+    sink = value;
+  }
+
+  void save(const std::vector<Result>& results, const std::string& path)
+  {
+    std::ofstream out(path);
+    out << "{\n  \"benchmarks\": [\n";
+    for (std::size_t i = 0; i < results.size(); ++i)
+    {
+      const auto& result = results[i];
+      out << "    {\"name\": \"" << result.name << "\", \"iterations\": " << result.iterations
+          << ", \"ns_per_op\": " << result.nsPerOp << ", \"allocs_per_op\": " << result.allocationsPerOp << "}"
+          << (i + 1 < results.size() ? ",\n" : "\n");
+    }
+    out << "  ]\n}\n";
+  }
+
+  // Reads files written by save(), one benchmark per line
+  std::vector<Result> load(const std::string& path)
+  {
+    std::vector<Result> results;
+    std::ifstream in(path);
+    if (!in)
+    {
+      std::cerr << "Could not read baseline " << path << std::endl;
+      return results;
+    }
+    const auto stringValue = [](const std::string& line, const std::string& key) -> std::string {
+      const auto start = line.find("\"" + key + "\": \"");
+      if (start == std::string::npos)
+        return {};
+      const auto begin = start + key.size() + 5;
+      return line.substr(begin, line.find('"', begin) - begin);
+    };
+    const auto numberValue = [](const std::string& line, const std::string& key) {
+      const auto start = line.find("\"" + key + "\": ");
+      if (start == std::string::npos)
+        return 0.0;
+      return std::strtod(line.c_str() + start + key.size() + 4, nullptr);
+    };
+    std::string line;
+    while (std::getline(in, line))
+    {
+      auto name = stringValue(line, "name");
+      if (name.empty())
+        continue;
+      results.push_back({std::move(name), static_cast<std::uint64_t>(numberValue(line, "iterations")),
+                         numberValue(line, "ns_per_op"), numberValue(line, "allocs_per_op")});
+    }
+    return results;
+  }
+
+  void print(const std::vector<Result>& results, const std::vector<Result>& baseline)
+  {
+    const auto nameWidth = static_cast<int>(
+        std::max_element(begin(results), end(results), [](const auto& a, const auto& b) {
+          return a.name.size() < b.name.size();
+        })->name.size());
+    std::cout << std::left << std::setw(nameWidth) << "Benchmark" << std::right << std::setw(14) << "ns/op"
+              << std::setw(14) << "allocs/op";
+    if (!baseline.empty())
+      std::cout << std::setw(14) << "base ns/op" << std::setw(10) << "change";
+    std::cout << std::endl;
+    std::cout << std::fixed;
+    for (const auto& result : results)
+    {
+      std::cout << std::left << std::setw(nameWidth) << result.name << std::right << std::setprecision(1)
+                << std::setw(14) << result.nsPerOp << std::setprecision(2) << std::setw(14)
+                << result.allocationsPerOp;
+      const auto base = std::find_if(begin(baseline), end(baseline),
+                                     [&name = result.name](const auto& other) { return other.name == name; });
+      if (base != end(baseline) && base->nsPerOp > 0)
+      {
+        std::ostringstream change;
+        change << std::showpos << std::fixed << std::setprecision(1)
+               << (result.nsPerOp / base->nsPerOp - 1) * 100 << "%";
+        std::cout << std::setprecision(1) << std::setw(14) << base->nsPerOp << std::setw(10) << change.str();
+      }
+      std::cout << std::endl;
+    }
+  }
+
+  int main(int argc, char* argv[], const std::vector<Benchmark>& benchmarks)
+  {
+    std::string filter;
+    std::string savePath;
+    std::string comparePath;
+    for (int i = 1; i < argc; ++i)
+    {
+      const std::string option = argv[i];
+      if (i + 1 == argc || (option != "--filter" && option != "--save" && option != "--compare"))
+      {
+        std::cerr << "Usage: " << argv[0] << " [--filter <text>] [--save <file>] [--compare <file>]" << std::endl;
+        return 1;
+      }
+      (option == "--filter" ? filter : option == "--save" ? savePath : comparePath) = argv[++i];
+    }
+
+    std::vector<Result> results;
+    for (const auto& [name, run] : benchmarks)
+    {
+      if (name.find(filter) == std::string::npos)
+        continue;
+      results.emplace_back(run()).name = name;
+    }
+    if (results.empty())
+    {
+      std::cerr << "No benchmark matches '" << filter << "'" << std::endl;
+      return 1;
+    }
+    print(results, comparePath.empty() ? std::vector<Result>{} : load(comparePath));
+    if (!savePath.empty())
+      save(results, savePath);
+    return 0;
+  }
+} // namespace benchmark
@@ -0,0 +1,136 @@
+#include "solver/Bounds.hpp"
+
+#include "solver/Fitness.hpp"
+
+#include "engine/Experience.hpp"
+
+#include <algorithm>
+
+namespace
+{
+  // Fitness points per visible monster for effects that are not modelled (piety, overhealing, conversion, ...).
+  // Chosen by judgement, not derived; the same holds for the other slack factors.
+  constexpr int SlackPerMonster = 50;
+
+  // Factor on the hero's damage per step for temporary bonuses (Bysseps, crushing blow, Weytwut, ...)
+  constexpr unsigned DamageSlack = 3;
+
+  // Greatest fireball multiplier: base 4, Flames, heavy fireball and Battlemage Ring
+  constexpr unsigned MaxFireballMultiplier = 10;
+
+  bool isAvailable(const ResourceSet& resources, Item item)
+  {
+    return std::find(begin(resources.shops), end(resources.shops), item) != end(resources.shops) ||
+           std::find(begin(resources.onGround), end(resources.onGround), item) != end(resources.onGround);
+  }
+
+  Hero optimisticHero(const GameState& state, std::span<const Item> helpfulItems)
+  {
+    auto hero = state.hero;
+    auto monsters = state.visibleMonsters;
+    for (const auto item : helpfulItems)
+    {
+      if (isAvailable(state.resources, item))
+        (void)hero.receive(item);
+    }
+
+    // Experience drops with the hero's level, so the current level gives the most per kill
+    unsigned experience = 0;
+    for (const auto& monster : monsters)
+    {
+      const auto xp =
+          Experience::forHeroAndMonsterLevels(Level{hero.getLevel()}, Level{monster.getLevel()}).get() * 3 / 2;
+      experience += xp + hero.getIntensity(HeroStatus::Learning) + 4;
+    }
+    // Gain one level at a time, as kills would, so that Might from level-ups does not stack (see Faith)
+    while (experience > 0 && hero.getXPforNextLevel() > hero.getXP())
+    {
+      const auto xp = std::min(experience, hero.getXPforNextLevel() - hero.getXP());
+      hero.reset(HeroStatus::Might);
+      hero.gainExperienceNoBonuses(xp, monsters);
+      experience -= xp;
+    }
+    hero.refillHealthAndMana();
+    return hero;
+  }
+
+  // Greatest damage the hero could deal to the monster in one step
+  unsigned maxDamagePerStep(const Hero& hero, const Monster& monster)
+  {
+    const auto melee = static_cast<unsigned>(hero.getDamageOutputVersus(monster)) * DamageSlack;
+    const auto fireball = hero.getLevel() * MaxFireballMultiplier * DamageSlack;
+    return std::max(melee, fireball);
+  }
+} // namespace
+
+namespace solver
+{
+  std::vector<Item> helpfulItems(const GameState& state)
+  {
+    std::vector<Item> items;
+    auto hero = state.hero;
+    const auto receiveIfHelpful = [&](Item item) {
+      auto candidate = hero;
+      if (candidate.receive(item) && candidate.getDamageVersusStandard() >= hero.getDamageVersusStandard() &&
+          candidate.getHitPointsMax() >= hero.getHitPointsMax())
+      {
+        hero = std::move(candidate);
+        items.push_back(item);
+      }
+    };
+    std::for_each(begin(state.resources.shops), end(state.resources.shops), receiveIfHelpful);
+    std::for_each(begin(state.resources.onGround), end(state.resources.onGround), receiveIfHelpful);
+    return items;
+  }
+
+  HeuristicBounds::HeuristicBounds(const GameState& state)
+    : HeuristicBounds(state, helpfulItems(state))
+  {
+  }
+
+  HeuristicBounds::HeuristicBounds(const GameState& state, std::span<const Item> helpfulItems)
+  {
+    using namespace fitness1;
+    const auto fitnessRating = StateFitnessRating1{};
+    if (state.hero.isDefeated())
+    {
+      maxFitness = fitnessRating.GAME_LOST;
+      return;
+    }
+    if (state.visibleMonsters.empty())
+    {
+      maxFitness = fitnessRating.GAME_WON;
+      minStepsToWin = 0;
+      return;
+    }
+
+    const auto hero = optimisticHero(state, helpfulItems);
+    const auto& resources = state.resources;
+    const auto numSpells = resources.spells.size() + resources.freeSpells.size();
+    const auto numMonsters = state.visibleMonsters.size();
+    // Learnt spells move from the resource score (100 or 90) to the inventory score (150).  A non-winning state
+    // has at least one monster left, with at least one hit point.
+    maxFitness = static_cast<int>(computeHeroScore(hero) + 50 + computeInventoryScore(hero) + 150 * numSpells +
+                                  computeResourceScore(resources)) +
+                 SlackPerMonster * static_cast<int>(numMonsters) - 100;
+
+    unsigned steps = 0;
+    for (const auto& monster : state.visibleMonsters)
+    {
+      const auto damage = maxDamagePerStep(hero, monster);
+      if (damage == 0)
+        return;
+      const auto hits = (monster.getHitPoints() + damage - 1) / damage;
+      // Every stack of death protection absorbs one lethal hit
+      steps = std::max(steps, std::max(hits, 1u + monster.getDeathProtection()));
+    }
+    minStepsToWin = steps;
+  }
+
+  int HeuristicBounds::within(unsigned numSteps) const
+  {
+    if (minStepsToWin && *minStepsToWin <= numSteps)
+      return StateFitnessRating1{}.GAME_WON;
+    return maxFitness;
+  }
+} // namespace solver
@@ -0,0 +1,57 @@
+#include "solver/DominanceStore.hpp"
+
+#include <algorithm>
+#include <bit>
+
+namespace solver
+{
+  Quantities::Quantities(const GameState& state)
+    : hitPoints(state.hero.getHitPoints())
+    , manaPoints(state.hero.getManaPoints())
+    , gold(state.hero.gold())
+    , hiddenTiles(state.resources.numHiddenTiles)
+    , moreHitPointsNeverHurt(!state.hero.has(HeroTrait::Determined) && !state.hero.has(Spell::Halpmeh))
+  {
+  }
+
+  bool Quantities::dominates(const Quantities& other) const
+  {
+    if (!moreHitPointsNeverHurt && hitPoints != other.hitPoints)
+      return false;
+    const bool atLeast = hitPoints >= other.hitPoints && manaPoints >= other.manaPoints && gold >= other.gold &&
+                         hiddenTiles >= other.hiddenTiles;
+    return atLeast && (hitPoints > other.hitPoints || manaPoints > other.manaPoints || gold > other.gold ||
+                       hiddenTiles > other.hiddenTiles);
+  }
+
+  DominanceStore::DominanceStore(std::size_t numBuckets)
+    : buckets(std::bit_ceil(std::max(numBuckets, std::size_t{1})))
+  {
+  }
+
+  bool DominanceStore::dominatedOrInsert(std::uint64_t identity, const Quantities& quantities, int depth)
+  {
+    const auto i = index(identity);
+    std::scoped_lock lock(lockFor(i));
+    auto& bucket = buckets[i];
+    const auto sameIdentity = [this, identity](const Entry& entry) {
+      return entry.identity == identity && entry.generation == generation;
+    };
+    if (std::any_of(begin(bucket), end(bucket), [&](const Entry& entry) {
+          return sameIdentity(entry) && entry.depth >= depth && entry.quantities.dominates(quantities);
+        }))
+      return true;
+
+    // Replace an entry that is no better and not deeper, otherwise an outdated or the shallowest one
+    auto slot = std::find_if(begin(bucket), end(bucket), [&](const Entry& entry) {
+      return sameIdentity(entry) && entry.depth <= depth &&
+             (entry.quantities == quantities || quantities.dominates(entry.quantities));
+    });
+    if (slot == end(bucket))
+      slot = std::min_element(begin(bucket), end(bucket), [this](const Entry& a, const Entry& b) {
+        return std::pair{a.generation == generation, a.depth} < std::pair{b.generation == generation, b.depth};
+      });
+    *slot = {identity, quantities, depth, generation};
+    return false;
+  }
+} // namespace solver
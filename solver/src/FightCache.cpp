@@ -0,0 +1,90 @@
+#include "solver/FightCache.hpp"
+
+#include "solver/StateHash.hpp"
+
+#include <algorithm>
+#include <bit>
+
+namespace solver
+{
+  namespace
+  {
+    std::uint64_t mix(std::uint64_t x)
+    {
+      x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ull;
+      x = (x ^ (x >> 27)) * 0x94d049bb133111ebull;
+      return x ^ (x >> 31);
+    }
+
+    // hash(hero) leaves out the traits, which do not change during a game but do change the outcome of fights
+    std::uint64_t combatKey(const Hero& hero)
+    {
+      auto key = hash(hero);
+      for (int i = 0; i <= static_cast<int>(HeroTrait::Last); ++i)
+      {
+        if (hero.has(static_cast<HeroTrait>(i)))
+          key = mix(key ^ static_cast<std::uint64_t>(i + 1));
+      }
+      return key;
+    }
+
+    // hash(monster) only records which traits a monster has, not their parameters
+    std::uint64_t combatKey(const Monster& monster)
+    {
+      const auto parameters = static_cast<std::uint64_t>(monster.getDeathGazePercent()) |
+                              (static_cast<std::uint64_t>(monster.getLifeStealPercent()) << 16) |
+                              (static_cast<std::uint64_t>(monster.getBerserkPercent()) << 32) |
+                              (static_cast<std::uint64_t>(monster.getKnockbackPercent()) << 48);
+      return hash(monster) ^ mix(parameters);
+    }
+  } // namespace
+
+  FightCache::FightCache(std::size_t numEntries)
+    : entries(std::bit_ceil(std::max(numEntries, std::size_t{1})))
+  {
+  }
+
+  std::size_t FightCache::index(std::uint64_t heroHash, std::uint64_t monsterHash) const
+  {
+    return (heroHash ^ std::rotl(monsterHash, 17)) & (entries.size() - 1);
+  }
+
+  heuristics::MeleeResult FightCache::predictMelee(const Hero& hero, const Monster& monster)
+  {
+    if (heuristics::isStationaryFight(hero, monster))
+      return heuristics::predictMelee(hero, monster);
+
+    const auto heroHash = combatKey(hero);
+    const auto monsterHash = combatKey(monster);
+    const auto i = index(heroHash, monsterHash);
+    {
+      std::scoped_lock lock(lockFor(i));
+      const auto& entry = entries[i];
+      if (entry.heroHash == heroHash && entry.monsterHash == monsterHash)
+      {
+        ++numHits;
+        return entry.result;
+      }
+    }
+    // Simulate without holding the lock; a concurrent identical prediction just stores the same result
+    const auto result = heuristics::predictMelee(hero, monster);
+    std::scoped_lock lock(lockFor(i));
+    entries[i] = {heroHash, monsterHash, result};
+    return result;
+  }
+
+  void FightCache::clear()
+  {
+    for (std::size_t i = 0; i < entries.size(); ++i)
+    {
+      std::scoped_lock lock(lockFor(i));
+      entries[i] = Entry{};
+    }
+  }
+
+  FightCache& sharedFightCache()
+  {
+    static FightCache cache;
+    return cache;
+  }
+} // namespace solver
@@ -1,80 +1,195 @@
+#include "solver/GeneticAlgorithm.hpp"
+
 #include "engine/Combat.hpp"
 #include "engine/HeroStatus.hpp"
+#include "engine/Random.hpp"
 #include "engine/Resources.hpp"
 #include "solver/Fitness.hpp"
+#include "solver/PackedStep.hpp"
+#include "solver/SolverControl.hpp"
 #include "solver/SolverTools.hpp"
+#include "solver/ValidSteps.hpp"
 
 #include <algorithm>
 #include <cassert>
 #include <execution>
-#include <iostream>
+#include <memory>
 #include <numeric>
 #include <optional>
 #include <random>
+#include <string>
+#include <thread>
+#include <unordered_map>
 
 const auto fitnessRating = StateFitnessRating1{};
 
 namespace
 {
   using namespace solver;
-  thread_local std::mt19937 generator{std::random_device{"/dev/urandom"}()};
+
+  // Intermediate states of evaluated solutions are stored every `checkpointInterval` steps.  They are identified by a
+  // hash of the steps leading to them, so that later generations can resume from the longest unchanged prefix.
+  constexpr std::size_t checkpointInterval = 8;
+
+  struct Checkpoint
+  {
+    std::uint64_t prefixHash;
+    std::shared_ptr<const GameState> state;
+  };
+
+  // Checkpoints of the previous generation by prefix hash; read-only while a generation is evaluated
+  using PrefixCache = std::unordered_map<std::uint64_t, std::shared_ptr<const GameState>>;
+
+  // FNV-1a over the 16-bit step encodings; the non-zero offset basis keeps prefixes of different length apart
+  constexpr std::uint64_t emptyPrefixHash = 0xcbf29ce484222325ull;
+
+  std::uint64_t extendPrefixHash(std::uint64_t prefixHash, PackedStep step)
+  {
+    return (prefixHash ^ step.raw()) * 0x100000001b3ull;
+  }
+
+  // Solutions are stored packed, so that copying and crossover of the population move 2 bytes per step
+  struct Candidate
+  {
+    PackedSolution solution{};
+    int score{0};
+    // Checkpoints at every multiple of `checkpointInterval` steps of the solution
+    std::vector<Checkpoint> checkpoints{};
+  };
+
+  // Solution under construction together with the state it leads to
+  struct Simulation
+  {
+    const GameState& initialState;
+    GameState state{initialState};
+    PackedSolution solution{};
+    std::vector<Checkpoint> checkpoints{};
+    std::uint64_t prefixHash{emptyPrefixHash};
+    // Added to the solver control when the simulation is finished
+    SolverCounts counts{};
+
+    // Record a step that has already been applied to `state`
+    void append(PackedStep step)
+    {
+      prefixHash = extendPrefixHash(prefixHash, step);
+      solution.push_back(step);
+      if (solution.size() % checkpointInterval == 0)
+        checkpoints.push_back({prefixHash, std::make_shared<const GameState>(state)});
+    }
+
+    // Restore the state reached by `solution`, e.g. after applying a step that defeated the hero
+    void restore()
+    {
+      state = checkpoints.empty() ? initialState : *checkpoints.back().state;
+      for (auto i = checkpoints.size() * checkpointInterval; i < solution.size(); ++i)
+      {
+        state = solver::apply(solution[i].unpack(), std::move(state));
+        ++counts.statesApplied;
+      }
+    }
+
+    // Continue from the longest prefix of `candidate` (up to `maxLength` steps) that is found in the cache
+    std::size_t resume(const PackedSolution& candidate, std::size_t maxLength, const PrefixCache& cache)
+    {
+      std::uint64_t hash = emptyPrefixHash;
+      for (std::size_t i = 0; i < maxLength; ++i)
+      {
+        hash = extendPrefixHash(hash, candidate[i]);
+        if ((i + 1) % checkpointInterval != 0)
+          continue;
+        const auto cached = cache.find(hash);
+        if (cached == end(cache))
+        {
+          ++counts.cacheMisses;
+          break;
+        }
+        ++counts.cacheHits;
+        checkpoints.push_back({hash, cached->second});
+      }
+      if (checkpoints.empty())
+        return 0;
+      const auto length = checkpoints.size() * checkpointInterval;
+      solution.assign(begin(candidate), begin(candidate) + static_cast<long>(length));
+      state = *checkpoints.back().state;
+      prefixHash = checkpoints.back().prefixHash;
+      return length;
+    }
+
+    Candidate finish(const StateFitnessRating& rate, SolverControl& control) &&
+    {
+      control.add(counts);
+      const auto score = rate(state);
+      return {std::move(solution), score, std::move(checkpoints)};
+    }
+  };
 
   // Random initial solution, stops close to hero's death
-  Solution initialSolution(GameState state)
+  Candidate initialSolution(const GameState& initialState, SolverControl& control)
   {
-    if (state.hero.isDefeated() || state.visibleMonsters.empty())
-      return {};
-    Solution initial;
-    while (true)
+    Simulation simulation{initialState};
+    auto& state = simulation.state;
+    while (!state.hero.isDefeated() && !state.visibleMonsters.empty() && simulation.solution.size() < 100)
     {
       Step step = generateRandomValidStep(state, false);
       assert(isValid(step, state));
       state = solver::apply(step, std::move(state));
+      ++simulation.counts.statesApplied;
       if (state.hero.isDefeated())
+      {
+        simulation.restore();
         break;
-      initial.emplace_back(std::move(step));
-      if (initial.size() == 100 || state.visibleMonsters.empty())
-        break;
+      }
+      simulation.append(step);
     }
-    return initial;
-  }
-
-  using OptionalStepResult = std::optional<std::pair<Step, GameState>>;
-
-  // Generate and apply random step.  If hero survives, returns step and resulting gamestate; nullopt otherwise.
-  OptionalStepResult makeRandomStep(GameState state, bool allowTargetChange)
-  {
-    auto randomStep = generateRandomValidStep(state, allowTargetChange);
-    state = solver::apply(randomStep, std::move(state));
-    if (!state.hero.isDefeated())
-      return std::pair{std::move(randomStep), std::move(state)};
-    return std::nullopt;
+    return std::move(simulation).finish(fitnessRating, control);
   }
 
-  // Generate and apply several random steps.  Return the most successful one and the resulting gamestate, or nullopt
-  // if the hero died in all attempted steps.
-  OptionalStepResult bestRandomStep(GameState state, const StateFitnessRating& rate, int num_attempts = 3)
+  // Generate and try several random steps.  Apply the most successful one, or return false if the hero died in all
+  // attempted steps.  Attempts are applied in place and reverted afterwards, so they are all drawn from the same set
+  // of valid steps.
+  bool applyBestRandomStep(Simulation& simulation, const StateFitnessRating& rate, int num_attempts)
   {
-    OptionalStepResult result;
+    auto& state = simulation.state;
+    const ValidSteps validSteps{state, false};
+    std::optional<Step> bestStep;
     int bestRating;
+    simulation.counts.statesApplied += static_cast<unsigned>(num_attempts) + 1;
     while (--num_attempts >= 0)
     {
-      auto candidate = num_attempts > 0 ? makeRandomStep(state, false) : makeRandomStep(std::move(state), false);
-      if (!candidate)
-        continue;
-      auto rating = rate(candidate->second);
-      if (!result || rating > bestRating)
+      auto candidate = validSteps.random();
+      auto undo = applyInPlace(candidate, state);
+      if (!state.hero.isDefeated())
       {
-        bestRating = rating;
-        result = std::move(candidate);
+        const auto rating = rate(state);
+        if (!bestStep || rating > bestRating)
+        {
+          bestRating = rating;
+          bestStep = candidate;
+        }
       }
+      unapply(candidate, std::move(undo), state);
+    }
+    if (!bestStep)
+      return false;
+    // Re-applying the step may lead to a different outcome if it involves random events
+    auto undo = applyInPlace(*bestStep, state);
+    if (state.hero.isDefeated())
+    {
+      unapply(*bestStep, std::move(undo), state);
+      return false;
     }
-    return result;
+    simulation.append(*bestStep);
+    return true;
   }
 
   // Applies mutations to a candidate solution, removes invalid steps and extends it with valid random steps.
-  // Stops when the hero would be defeated by the next action.  Returns updated state.
-  Solution mutateAndClean(Solution candidate, GameState state, double temperature)
+  // Stops when the hero would be defeated by the next action.  Returns the new solution and its rating.
+  // The simulation starts from the longest prefix of the mutated solution that is found in the cache.
+  Candidate mutateAndClean(PackedSolution candidate,
+                           const GameState& initialState,
+                           double temperature,
+                           const PrefixCache& cache,
+                           SolverControl& control)
   {
     // The following probabilities are interpreted per step of current candidate.
     // The mutations are applied in this order:
@@ -87,174 +202,297 @@ namespace
     const double probability_insert = 0.04 * temperature;
 
     int num_mutations =
-        std::poisson_distribution<>(static_cast<double>(candidate.size()) * probability_erasure)(generator);
+        std::poisson_distribution<>(static_cast<double>(candidate.size()) * probability_erasure)(randomGenerator());
     while (--num_mutations >= 0 && !candidate.empty())
     {
-      const int pos = std::uniform_int_distribution<>(0, static_cast<int>(candidate.size()) - 1)(generator);
+      const int pos = std::uniform_int_distribution<>(0, static_cast<int>(candidate.size()) - 1)(randomGenerator());
       candidate.erase(begin(candidate) + pos);
     }
     if (!candidate.empty())
     {
       num_mutations =
-          std::poisson_distribution<>(static_cast<double>(candidate.size()) * probability_swap_any)(generator);
+          std::poisson_distribution<>(static_cast<double>(candidate.size()) * probability_swap_any)(randomGenerator());
       while (--num_mutations >= 0)
       {
-        const size_t posA = std::uniform_int_distribution<size_t>(0, candidate.size() - 1)(generator);
-        const size_t posB = std::uniform_int_distribution<size_t>(0, candidate.size() - 1)(generator);
+        const size_t posA = std::uniform_int_distribution<size_t>(0, candidate.size() - 1)(randomGenerator());
+        const size_t posB = std::uniform_int_distribution<size_t>(0, candidate.size() - 1)(randomGenerator());
         if (posA != posB)
           std::swap(candidate[posA], candidate[posB]);
       }
     }
     if (candidate.size() >= 2)
     {
-      num_mutations =
-          std::poisson_distribution<>(static_cast<double>(candidate.size()) * probability_swap_neighbor)(generator);
+      num_mutations = std::poisson_distribution<>(static_cast<double>(candidate.size()) * probability_swap_neighbor)(
+          randomGenerator());
       while (--num_mutations >= 0)
       {
-        const size_t pos = std::uniform_int_distribution<size_t>(0, candidate.size() - 2)(generator);
+        const size_t pos = std::uniform_int_distribution<size_t>(0, candidate.size() - 2)(randomGenerator());
         std::swap(candidate[pos], candidate[pos + 1]);
       }
     }
 
+    // Decide on insertions beforehand, so that the steps up to the first insertion can be taken from the cache
     auto rand = std::uniform_real_distribution<double>();
-    Solution cleanedSolution;
-    cleanedSolution.reserve(static_cast<size_t>(static_cast<double>(candidate.size()) * (1 + 3 * probability_insert)));
-    for (auto& step : candidate)
+    std::vector<char> insertAfter(candidate.size());
+    for (auto& insert : insertAfter)
+      insert = rand(randomGenerator()) < probability_insert;
+    const auto firstInsertion =
+        static_cast<std::size_t>(std::find(begin(insertAfter), end(insertAfter), true) - begin(insertAfter));
+
+    Simulation simulation{initialState};
+    auto& state = simulation.state;
+    bool heroDefeated = false;
+    for (auto i = simulation.resume(candidate, firstInsertion, cache); i < candidate.size(); ++i)
     {
+      const auto step = candidate[i].unpack();
       if (!isValid(step, state))
+      {
+        ++simulation.counts.invalidSteps;
         continue;
+      }
       state = solver::apply(step, std::move(state));
+      ++simulation.counts.statesApplied;
       if (state.hero.isDefeated())
+      {
+        simulation.restore();
+        heroDefeated = true;
         break;
-      cleanedSolution.emplace_back(std::move(step));
+      }
+      simulation.append(candidate[i]);
       if (state.visibleMonsters.empty())
         break;
-      if (rand(generator) < probability_insert)
+      if (insertAfter[i])
       {
-        auto bestRandom = bestRandomStep(std::move(state), fitnessRating, 5);
-        if (!bestRandom)
-          break;
-        cleanedSolution.emplace_back(std::move(bestRandom->first));
-        state = std::move(bestRandom->second);
-        if (state.visibleMonsters.empty())
+        if (!applyBestRandomStep(simulation, fitnessRating, 5) || state.visibleMonsters.empty())
           break;
       }
     }
-    if (!state.hero.isDefeated() && !state.visibleMonsters.empty())
+    if (!heroDefeated)
     {
-      while (true)
+      while (!state.visibleMonsters.empty())
       {
-        auto bestRandom = bestRandomStep(std::move(state), fitnessRating, 3);
-        if (!bestRandom)
-          break;
-        cleanedSolution.emplace_back(std::move(bestRandom->first));
-        state = std::move(bestRandom->second);
-        if (state.visibleMonsters.empty())
+        if (!applyBestRandomStep(simulation, fitnessRating, 3))
           break;
       }
     }
-    return cleanedSolution;
+    return std::move(simulation).finish(fitnessRating, control);
   }
-} // namespace
-
-std::optional<Solution> runGeneticAlgorithm(GameState state)
-{
-  state.hero.add(HeroStatus::Pessimist);
-  const unsigned num_generations = 100;
-  const unsigned generation_size = 1000;
-  // Keep `num_keep` top performers, multiply them to reach original generation size
-  const unsigned num_keep = 100;
-
-  // Create and rate initial generation of solutions
-  std::array<std::pair<Solution, int>, generation_size> population;
-  bool initialized = false;
-  int best_previous = 0;
-  double temperature = 1;
-  for (unsigned gen = 0; gen < num_generations; ++gen)
+  // Sub-population with its own selection and temperature schedule.  Islands only interact through migration.
+  class Island
   {
-    if (!initialized)
+  public:
+    Island(const GameState& initialState, unsigned index, unsigned size, bool runParallel)
+      : initialState(initialState)
+      , index(index)
+      , population(size, Candidate{.score = fitnessRating.GAME_LOST})
+      , numKeep(std::max(size / 10, 1u))
+      , runParallel(runParallel)
+    {
+    }
+
+    // Evolve for the given number of generations, or until a candidate wins the game.
+    // Afterwards, the population is sorted by score.
+    void evolve(unsigned numGenerations, SolverControl& control)
+    {
+      for (unsigned gen = 0; gen < numGenerations; ++gen)
+      {
+        ++generation;
+        if (!initialized)
+        {
+          if (control.shouldStop())
+            return;
+          const auto generateInitial = [&](Candidate& candidate) {
+            control.reseed(stream(candidate));
+            candidate = initialSolution(initialState, control);
+          };
+          if (runParallel)
+            std::for_each(std::execution::par_unseq, begin(population), end(population), generateInitial);
+          else
+            std::for_each(begin(population), end(population), generateInitial);
+          initialized = true;
+          control.addNodes(population.size());
+        }
+
+        sort();
+        const auto bestScore = population.front().score;
+        if (bestScore == fitnessRating.GAME_WON || control.shouldStop())
+          return;
+
+        if (bestScore <= bestPrevious)
+          temperature += 0.1;
+        else
+          temperature /= 2;
+        bestPrevious = bestScore;
+
+        if (temperature > 3)
+        {
+          // start over
+          initialized = false;
+          temperature = 1;
+          continue;
+        }
+
+        spawn(control);
+        control.addNodes(population.size() - 1);
+      }
+      sort();
+    }
+
+    const Candidate& best() const { return population.front(); }
+    double getTemperature() const { return temperature; }
+
+    std::vector<Candidate> emigrants(unsigned count) const
     {
-      std::generate(std::execution::par_unseq, begin(population), end(population), [&state] {
-        auto candidate = initialSolution(state);
-        const auto finalState = solver::apply(candidate, state);
-        return std::pair{std::move(candidate), fitnessRating(finalState)};
-      });
-      initialized = true;
+      return {begin(population), begin(population) + std::min<long>(count, static_cast<long>(population.size()))};
     }
 
-    std::stable_sort(begin(population), end(population),
-                     [](const auto& scoredCandidateA, const auto& scoredCandidateB) {
-                       return scoredCandidateA.second > scoredCandidateB.second;
-                     });
-
-    const auto& [bestSolution, bestScore] = population.front();
-    std::cout << "Generation " << gen << " complete:" << std::endl;
-    std::cout << "  Highest fitness score: " << bestScore << std::endl;
-    std::cout << "  Lowest retained fitness score: " << population[num_keep - 1].second << std::endl;
-    std::cout << "  Current temperature: " << static_cast<int>(temperature * 100) << std::endl;
-    std::cout << "  Best candidate: " << std::endl << "  " << toString(bestSolution) << std::endl;
-    fitnessRating.explain(apply(bestSolution, state));
-    std::cout << std::string(80, '-') << std::endl;
-    if (bestScore == fitnessRating.GAME_WON)
-      return bestSolution;
-
-    if (bestScore <= best_previous)
-      temperature += 0.1;
-    else
-      temperature /= 2;
-    best_previous = bestScore;
-
-    if (temperature > 3)
+    // Replace the weakest candidates
+    void immigrate(const std::vector<Candidate>& immigrants)
     {
-      // start over
-      initialized = false;
-      temperature = 1;
-      continue;
+      const auto count = std::min(immigrants.size(), population.size() - 1);
+      const auto numImmigrants = static_cast<long>(count);
+      std::copy(begin(immigrants), begin(immigrants) + numImmigrants, end(population) - numImmigrants);
     }
 
-    // A) Spawn new generation of candidate solutions by mixing successful solutions
-    // Fill array with copies of `num_keep` most successful solutions
-    auto n = num_keep;
-    while (n < generation_size)
+  private:
+    void sort()
     {
-      const auto num_copy = std::min(num_keep, generation_size - n);
-      std::copy(begin(population), begin(population) + num_copy, begin(population) + n);
-      n += num_keep;
+      std::stable_sort(begin(population), end(population),
+                       [](const auto& scoredCandidateA, const auto& scoredCandidateB) {
+                         return scoredCandidateA.score > scoredCandidateB.score;
+                       });
     }
 
-    // Shuffle, but always keep (one) best solution at the first position
-    std::shuffle(begin(population) + 1, end(population), generator);
+    // Random stream of a candidate in the current generation (@see SolverControl::reseed)
+    std::uint64_t stream(const Candidate& candidate) const
+    {
+      const auto position = static_cast<std::uint64_t>(&candidate - population.data());
+      return (static_cast<std::uint64_t>(index) << 48) ^ (generation << 24) ^ (position + 1);
+    }
 
-    // Generate new solution candidates by intertwining two existing candidates
-    for (unsigned j = 2; j < generation_size; j += 2)
+    // Replace all but the best candidate by offspring of the `numKeep` most successful ones
+    void spawn(SolverControl& control)
     {
-      auto& solutionA = population[j - 1].first;
-      auto& solutionB = population[j].first;
-      const auto maxSize = std::max(solutionA.size(), solutionB.size());
-      if (solutionA.size() < maxSize)
-        solutionA.resize(maxSize);
+      // The best candidate is not modified, its stream is used for selection and crossover
+      control.reseed(stream(population.front()));
+
+      // A) Spawn new generation of candidate solutions by mixing successful solutions
+      // Fill array with copies of `numKeep` most successful solutions
+      const auto size = population.size();
+      auto n = numKeep;
+      while (n < size)
+      {
+        const auto num_copy = std::min<std::size_t>(numKeep, size - n);
+        std::copy(begin(population), begin(population) + static_cast<long>(num_copy),
+                  begin(population) + static_cast<long>(n));
+        n += numKeep;
+      }
+
+      // Shuffle, but always keep (one) best solution at the first position
+      std::shuffle(begin(population) + 1, end(population), randomGenerator());
+
+      // Generate new solution candidates by intertwining two existing candidates
+      for (std::size_t j = 2; j < size; j += 2)
+      {
+        auto& solutionA = population[j - 1].solution;
+        auto& solutionB = population[j].solution;
+        const auto maxSize = std::max(solutionA.size(), solutionB.size());
+        if (solutionA.size() < maxSize)
+          solutionA.resize(maxSize);
+        else
+          solutionB.resize(maxSize);
+        const auto cutPosition = std::uniform_int_distribution<long>(0, static_cast<long>(maxSize))(randomGenerator());
+        // Replace from start up to random cut position, so vector sizes do not need to be changed
+        PackedSolution tempSegment{begin(solutionA), begin(solutionA) + cutPosition};
+        std::copy(begin(solutionB), begin(solutionB) + cutPosition, begin(solutionA));
+        std::copy(begin(tempSegment), end(tempSegment), begin(solutionB));
+      }
+      // Checkpoints of the previous generation stay valid, since they are identified by the steps leading to them
+      PrefixCache cache;
+      for (const auto& candidate : population)
+      {
+        for (const auto& checkpoint : candidate.checkpoints)
+          cache.emplace(checkpoint.prefixHash, checkpoint.state);
+      }
+
+      // B) Random mutations
+      // C) Clean up solutions and update scores
+      const auto mutate = [&](Candidate& entry) {
+        control.reseed(stream(entry));
+        entry = mutateAndClean(std::move(entry.solution), initialState, temperature, cache, control);
+      };
+      if (runParallel)
+        std::for_each(std::execution::par_unseq, begin(population) + 1, end(population), mutate);
       else
-        solutionB.resize(maxSize);
-      const auto cutPosition = std::uniform_int_distribution<long>(0, static_cast<long>(maxSize))(generator);
-      // Replace from start up to random cut position, so vector sizes do not need to be changed
-      std::vector<Step> tempSegment{begin(solutionA), begin(solutionA) + cutPosition};
-      std::copy(begin(solutionB), begin(solutionB) + cutPosition, begin(solutionA));
-      std::copy(begin(tempSegment), end(tempSegment), begin(solutionB));
+        std::for_each(begin(population) + 1, end(population), mutate);
     }
-    // Run in parallel:
-    // B) Random mutations
-    // C) Clean up solutions and update scores
-    std::for_each(std::execution::par_unseq, begin(population) + 1, end(population), [&](auto& entry) {
-      auto cleaned = mutateAndClean(std::move(entry.first), state, temperature);
-      const auto finalState = solver::apply(cleaned, state);
-      entry = {std::move(cleaned), fitnessRating(finalState)};
+
+    const GameState& initialState;
+    unsigned index;
+    std::uint64_t generation{0};
+    std::vector<Candidate> population;
+    // Keep `numKeep` top performers, multiply them to reach original population size
+    unsigned numKeep;
+    // Evaluate candidates in parallel (single island) or sequentially (one island per thread)
+    bool runParallel;
+    bool initialized{false};
+    int bestPrevious{0};
+    double temperature{1};
+  };
+} // namespace
+
+std::optional<Solution>
+runGeneticAlgorithm(GameState state, SolverControl& control, const GeneticAlgorithmSettings& settings)
+{
+  state.hero.add(HeroStatus::Pessimist);
+  // The total population does not grow with the number of islands, so neither does the work per generation
+  constexpr unsigned MinIslandSize = 50;
+  const auto populationSize = std::max(settings.populationSize, 2u);
+  const auto numIslands =
+      std::clamp(settings.numIslands > 0 ? settings.numIslands : std::thread::hardware_concurrency(), 1u,
+                 std::max(populationSize / MinIslandSize, 1u));
+  const auto islandSize = populationSize / numIslands;
+  const auto numMigrants = std::max(islandSize / 50, 1u);
+  // A single population is evaluated in parallel and reported after every generation
+  const auto generationsPerEpoch = numIslands > 1 ? settings.migrationInterval : 1u;
+
+  std::vector<Island> islands;
+  islands.reserve(numIslands);
+  for (unsigned i = 0; i < numIslands; ++i)
+    islands.emplace_back(state, i, islandSize, numIslands == 1);
+
+  const auto bestIsland = [&islands] {
+    return std::max_element(begin(islands), end(islands),
+                            [](const auto& a, const auto& b) { return a.best().score < b.best().score; });
+  };
+  for (unsigned gen = 0; gen < settings.numGenerations; gen += generationsPerEpoch)
+  {
+    const auto numGenerations = std::min(generationsPerEpoch, settings.numGenerations - gen);
+    std::for_each(std::execution::par, begin(islands), end(islands),
+                  [&](Island& island) { island.evolve(numGenerations, control); });
+
+    const auto& [bestSolution, bestScore, bestCheckpoints] = bestIsland()->best();
+    control.trace([&, &bestSolution = bestSolution, bestScore = bestScore] {
+      std::string temperatures = "temperatures:";
+      for (const auto& island : islands)
+        temperatures += " " + std::to_string(static_cast<int>(island.getTemperature() * 100));
+      return TraceEvent{"generation", gen + numGenerations - 1, bestScore, toString(unpack(bestSolution)),
+                        std::move(temperatures)};
     });
+    control.report(gen + numGenerations - 1, bestScore);
+    if (bestScore == fitnessRating.GAME_WON || control.shouldStop())
+      return unpack(bestSolution);
+
+    // Migration along a ring of islands: the best candidates of each island replace the weakest of the next one
+    if (numIslands > 1)
+    {
+      std::vector<std::vector<Candidate>> emigrants;
+      for (const auto& island : islands)
+        emigrants.emplace_back(island.emigrants(numMigrants));
+      for (unsigned i = 0; i < numIslands; ++i)
+        islands[(i + 1) % numIslands].immigrate(emigrants[i]);
+    }
   }
 
-  auto& best = std::max_element(begin(population), end(population), [](const auto& a, const auto& b) {
-                 return a.second < b.second;
-               })->first;
-  const auto finalState = solver::apply(best, state);
-  fitnessRating.explain(finalState);
-  return std::move(best);
+  return unpack(bestIsland()->best().solution);
 }
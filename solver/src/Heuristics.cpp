@@ -1,8 +1,12 @@
 #include "solver/Heuristics.hpp"
 
+#include "solver/FightCache.hpp"
+
 #include "engine/Combat.hpp"
 #include "engine/Magic.hpp"
 
+#include <algorithm>
+#include <array>
 #include <numeric>
 
 namespace heuristics
@@ -94,18 +98,129 @@ namespace heuristics
     thread_local SimpleResources ignoreResources;
   } // namespace
 
-  bool checkMeleeOnly(Hero hero, Monster monster)
+  // Every attack deals the same damage to either side, and nothing else that matters changes in between
+  bool isStationaryFight(const Hero& hero, const Monster& monster)
   {
-    // Deny dodging
-    hero.add(HeroStatus::Pessimist);
+    constexpr std::array changingStatuses{
+        HeroStatus::BurningStrike, HeroStatus::ConsecratedStrike, HeroStatus::CorrosiveStrike,
+        HeroStatus::CrushingBlow,  HeroStatus::DeathGaze,         HeroStatus::FirstStrikeTemporary,
+        HeroStatus::LifeSteal,     HeroStatus::Might,             HeroStatus::Poisonous,
+        HeroStatus::Reflexes,      HeroStatus::Schadenfreude,     HeroStatus::SpiritStrength,
+        HeroStatus::StoneSkin,     HeroStatus::ByssepsStacks};
+    constexpr std::array changingTraits{HeroTrait::Determined, HeroTrait::ManaShield, HeroTrait::Momentum,
+                                        HeroTrait::Stabber, HeroTrait::SwiftHand};
+    constexpr std::array changingMonsterTraits{MonsterTrait::Corrosive, MonsterTrait::CurseBearer,
+                                               MonsterTrait::Weakening};
+    const auto heroHas = [&hero](auto statusOrTrait) { return hero.has(statusOrTrait); };
+    const auto monsterHas = [&monster](MonsterTrait trait) { return monster.has(trait); };
+    return std::none_of(begin(changingStatuses), end(changingStatuses), heroHas) &&
+           std::none_of(begin(changingTraits), end(changingTraits), heroHas) && !hero.has(ShopItem::Trisword) &&
+           hero.getDodgeChancePercent() < 100 &&
+           std::none_of(begin(changingMonsterTraits), end(changingMonsterTraits), monsterHas) &&
+           !monster.isBurning() && monster.getBerserkPercent() == 0 && monster.getDeathGazePercent() == 0;
+  }
 
-    while (!hero.isDefeated())
+  namespace
+  {
+    MeleeResult simulateMelee(Hero hero, Monster monster)
     {
-      Combat::attack(hero, monster, ignoreMonsters, ignoreResources);
-      if (monster.isDefeated())
-        return true;
+      // Deny dodging
+      hero.add(HeroStatus::Pessimist);
+
+      const bool heroDeathProtection = hero.has(HeroStatus::DeathProtection);
+      const auto monsterDeathProtection = monster.getDeathProtection();
+      MeleeResult result;
+      auto maxIterations = 200;
+      while (!hero.isDefeated() && !monster.isDefeated() && maxIterations-- > 0)
+      {
+        const bool heroInitiative = hero.hasInitiativeVersus(monster);
+        Combat::attack(hero, monster, ignoreMonsters, ignoreResources);
+        ++result.numAttacks;
+        // Not exact if the hero has Reflexes and defeats the monster with the second strike
+        if (!heroInitiative || !monster.isDefeated())
+          ++result.numHitsTaken;
+      }
+      if (!hero.isDefeated() && !monster.isDefeated())
+        return {};
+      result.heroHitPoints = hero.getHitPoints();
+      result.monsterHitPoints = monster.getHitPoints();
+      result.heroDeathProtectionUsed = heroDeathProtection && !hero.has(HeroStatus::DeathProtection);
+      result.monsterDeathProtectionUsed = monsterDeathProtection - monster.getDeathProtection();
+      result.heroWins = monster.isDefeated();
+      return result;
+    }
+
+    unsigned ceilDiv(unsigned numerator, unsigned denominator)
+    {
+      return (numerator + denominator - 1) / denominator;
     }
-    return false;
+  } // namespace
+
+  MeleeResult predictMelee(const Hero& hero, const Monster& monster)
+  {
+    if (hero.isDefeated() || monster.isDefeated())
+      return {.heroHitPoints = hero.getHitPoints(), .heroWins = monster.isDefeated()};
+    if (!isStationaryFight(hero, monster))
+      return simulateMelee(hero, monster);
+
+    const auto heroDamage = monster.predictDamageTaken(hero.getDamageOutputVersus(monster), hero.damageType());
+    const auto monsterDamage = hero.predictDamageTaken(monster.getDamage(), monster.damageType());
+    if (heroDamage == 0 && monsterDamage == 0)
+      return {};
+
+    // A slowed monster is no longer slowed after the hero's first strike
+    const bool initiativeFirstAttack = hero.hasInitiativeVersus(monster);
+    const bool initiative = hero.hasInitiativeVersusIgnoreMonsterSlowed(monster);
+    const auto initiativeInAttack = [&](unsigned attack) { return attack == 1 ? initiativeFirstAttack : initiative; };
+
+    // Strikes until hit points are down to zero, then one more per death protection
+    const auto heroHitPoints = hero.getHitPoints();
+    const bool heroDeathProtection = hero.has(HeroStatus::DeathProtection);
+    const auto monsterHitPoints = monster.getHitPoints();
+    const auto monsterDeathProtection = monster.getDeathProtection();
+    const auto strikesToZeroMonster = heroDamage > 0 ? ceilDiv(monsterHitPoints, heroDamage) : 0u;
+    const auto strikesToZeroHero = monsterDamage > 0 ? ceilDiv(heroHitPoints, monsterDamage) : 0u;
+
+    // Every attack includes one strike of the monster, except an attack the hero wins before the monster strikes
+    if (heroDamage > 0)
+    {
+      const auto numAttacks = strikesToZeroMonster + monsterDeathProtection;
+      const auto numHitsTaken = numAttacks - (initiativeInAttack(numAttacks) ? 1u : 0u);
+      const auto hitsSurvived = strikesToZeroHero - 1 + (heroDeathProtection ? 1u : 0u);
+      if (monsterDamage == 0 || numHitsTaken <= hitsSurvived)
+      {
+        // A level up for defeating the monster changes the hero's hit points; leave that to the simulation
+        const bool slowedInFinalAttack = numAttacks == 1 && monster.isSlowed();
+        if (hero.getXP() + hero.predictExperienceForKill(monster.getLevel(), slowedInFinalAttack) >=
+            hero.getXPforNextLevel())
+          return simulateMelee(hero, monster);
+        const bool heroDeathProtectionUsed = monsterDamage > 0 && numHitsTaken == strikesToZeroHero;
+        return {.numAttacks = numAttacks,
+                .numHitsTaken = numHitsTaken,
+                .heroHitPoints = heroDeathProtectionUsed ? 1u : heroHitPoints - numHitsTaken * monsterDamage,
+                .monsterHitPoints = 0,
+                .heroDeathProtectionUsed = heroDeathProtectionUsed,
+                .monsterDeathProtectionUsed = monsterDeathProtection,
+                .heroWins = true};
+      }
+    }
+
+    // The hero is defeated by the first strike beyond those survived, which happens in the attack of the same number
+    const auto numAttacks = strikesToZeroHero + (heroDeathProtection ? 1u : 0u);
+    const auto numStrikes = numAttacks - (initiativeInAttack(numAttacks) ? 0u : 1u);
+    const bool monsterDeathProtectionUsed = heroDamage > 0 && numStrikes >= strikesToZeroMonster;
+    return {.numAttacks = numAttacks,
+            .numHitsTaken = numAttacks,
+            .heroHitPoints = 0,
+            .monsterHitPoints = monsterDeathProtectionUsed ? 1u : monsterHitPoints - numStrikes * heroDamage,
+            .heroDeathProtectionUsed = heroDeathProtection,
+            .monsterDeathProtectionUsed = monsterDeathProtectionUsed ? numStrikes - strikesToZeroMonster + 1 : 0u,
+            .heroWins = false};
+  }
+
+  bool checkMeleeOnly(const Hero& hero, const Monster& monster)
+  {
+    return solver::sharedFightCache().predictMelee(hero, monster).heroWins;
   }
 
   inline bool canRecover(const Hero& hero)
@@ -0,0 +1,237 @@
+#include "solver/MonteCarloTreeSearch.hpp"
+
+#include "solver/Fitness.hpp"
+#include "solver/SolverTools.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <execution>
+#include <limits>
+#include <memory>
+#include <thread>
+#include <utility>
+
+namespace
+{
+  using Clock = std::chrono::steady_clock;
+
+  const auto fitnessRating = StateFitnessRating1{};
+
+  struct Node
+  {
+    Node(GameState state, Step step, std::size_t stepIndex, Node* parent)
+      : state(std::move(state))
+      , step(std::move(step))
+      , stepIndex(stepIndex)
+      , parent(parent)
+    {
+    }
+
+    bool isTerminal() const { return state.hero.isDefeated() || state.visibleMonsters.empty(); }
+    bool isFullyExpanded() const { return stepsGenerated && children.size() == steps.size(); }
+
+    GameState state;
+    // Step leading from the parent to this node, and its position in the parent's list of valid steps
+    Step step;
+    std::size_t stepIndex;
+    Node* parent;
+
+    // All valid steps from this state, expanded in order
+    std::vector<Step> steps{};
+    bool stepsGenerated{false};
+    std::vector<std::unique_ptr<Node>> children{};
+
+    unsigned visits{0};
+    double totalReward{0};
+  };
+
+  // Map fitness to [0, 1]; intermediate states are rated relative to the state the search started from
+  double reward(int score, int rootScore)
+  {
+    if (score == fitnessRating.GAME_WON)
+      return 1;
+    if (score == fitnessRating.GAME_LOST)
+      return 0;
+    return 0.5 + 0.4 * std::tanh((score - rootScore) / 2000.0);
+  }
+
+  Node& selectChild(const Node& node, double exploration)
+  {
+    const auto logVisits = std::log(static_cast<double>(node.visits));
+    Node* best = nullptr;
+    double bestValue = -std::numeric_limits<double>::infinity();
+    for (auto& child : node.children)
+    {
+      const auto visits = static_cast<double>(child->visits);
+      const auto value = child->totalReward / visits + exploration * std::sqrt(logVisits / visits);
+      if (value > bestValue)
+      {
+        bestValue = value;
+        best = child.get();
+      }
+    }
+    return *best;
+  }
+
+  // Add the next unexplored child; returns the node itself if there is no valid step
+  Node& expand(Node& node, SolverCounts& counts)
+  {
+    if (!node.stepsGenerated)
+    {
+      node.steps = solver::generateAllValidSteps(node.state, false);
+      node.stepsGenerated = true;
+    }
+    if (node.isFullyExpanded())
+      return node;
+    const auto index = node.children.size();
+    const auto& step = node.steps[index];
+    ++counts.statesApplied;
+    node.children.emplace_back(std::make_unique<Node>(solver::apply(step, node.state), step, index, &node));
+    return *node.children.back();
+  }
+
+  struct PlayoutResult
+  {
+    int score;
+    Solution steps;
+    bool heroDefeated;
+  };
+
+  // Apply random steps, stopping before the hero would be defeated (like the initial solutions of the genetic
+  // algorithm).  The score is the one of the last state before the hero's defeat.
+  PlayoutResult playout(GameState state, unsigned maxLength, SolverCounts& counts)
+  {
+    PlayoutResult result{fitnessRating(state), {}, false};
+    while (result.score != fitnessRating.GAME_WON && result.steps.size() < maxLength)
+    {
+      auto step = solver::generateRandomValidStep(state, false);
+      state = solver::apply(step, std::move(state));
+      ++counts.statesApplied;
+      if (state.hero.isDefeated())
+      {
+        result.heroDefeated = true;
+        break;
+      }
+      result.score = fitnessRating(state);
+      result.steps.emplace_back(std::move(step));
+    }
+    return result;
+  }
+
+  struct TreeResult
+  {
+    // Visit counts of the root's children, indexed like generateAllValidSteps
+    std::vector<unsigned> rootVisits;
+    // Steps of a winning line, if one was found
+    std::optional<Solution> winningLine;
+  };
+
+  TreeResult searchTree(const GameState& rootState,
+                        const MonteCarloSettings& settings,
+                        unsigned numIterations,
+                        Clock::time_point deadline,
+                        const std::atomic<bool>& solved,
+                        SolverControl& control)
+  {
+    Node root{rootState, NoOp{}, 0, nullptr};
+    const auto rootScore = fitnessRating(rootState);
+    TreeResult result;
+    // Added to the solver control in batches, together with the checks for stopping
+    SolverCounts counts;
+    for (unsigned iteration = 0; iteration < numIterations; ++iteration)
+    {
+      if (iteration % 32 == 0)
+      {
+        control.add(std::exchange(counts, {}));
+        if (solved || Clock::now() > deadline || control.shouldStop())
+          break;
+      }
+      control.addNodes(1);
+
+      Node* node = &root;
+      while (!node->isTerminal() && node->isFullyExpanded() && !node->children.empty())
+        node = &selectChild(*node, settings.exploration);
+      if (!node->isTerminal())
+        node = &expand(*node, counts);
+
+      auto [score, playoutSteps, heroDefeated] = node->isTerminal()
+                                                     ? PlayoutResult{fitnessRating(node->state), {}, false}
+                                                     : playout(node->state, settings.maxPlayoutLength, counts);
+      if (score == fitnessRating.GAME_WON)
+      {
+        Solution line;
+        for (const Node* n = node; n->parent; n = n->parent)
+          line.push_back(n->step);
+        std::reverse(begin(line), end(line));
+        std::move(begin(playoutSteps), end(playoutSteps), std::back_inserter(line));
+        result.winningLine = std::move(line);
+        break;
+      }
+
+      // Playouts ending in defeat count less, even if the state before was rated well
+      const auto value = heroDefeated ? reward(score, rootScore) / 2 : reward(score, rootScore);
+      for (; node; node = node->parent)
+      {
+        ++node->visits;
+        node->totalReward += value;
+      }
+    }
+
+    control.add(counts);
+    result.rootVisits.resize(root.steps.size());
+    for (const auto& child : root.children)
+      result.rootVisits[child->stepIndex] = child->visits;
+    return result;
+  }
+} // namespace
+
+std::optional<Solution>
+runMonteCarloTreeSearch(GameState state, SolverControl& control, const MonteCarloSettings& settings)
+{
+  state.hero.add(HeroStatus::Pessimist);
+  const auto numThreads =
+      settings.numThreads > 0 ? settings.numThreads : std::max(1u, std::thread::hardware_concurrency());
+  const auto iterationsPerThread = (settings.iterationsPerStep + numThreads - 1) / numThreads;
+  const auto deadline = Clock::now() + settings.timeBudget;
+
+  Solution solution;
+  while (!state.visibleMonsters.empty() && Clock::now() < deadline && !control.shouldStop())
+  {
+    std::atomic<bool> solved{false};
+    std::vector<TreeResult> results(numThreads);
+    std::for_each(std::execution::par, begin(results), end(results), [&](TreeResult& result) {
+      control.reseed((solution.size() << 16) | static_cast<std::size_t>(&result - results.data()));
+      result = searchTree(state, settings, iterationsPerThread, deadline, solved, control);
+      if (result.winningLine)
+        solved = true;
+    });
+
+    const auto winner =
+        std::find_if(begin(results), end(results), [](const auto& result) { return result.winningLine.has_value(); });
+    if (winner != end(results))
+    {
+      std::move(begin(*winner->winningLine), end(*winner->winningLine), std::back_inserter(solution));
+      return solution;
+    }
+
+    // Root parallelisation: commit to the step visited most often across all trees
+    const auto steps = solver::generateAllValidSteps(state, false);
+    std::vector<unsigned> visits(steps.size());
+    for (const auto& result : results)
+    {
+      for (std::size_t i = 0; i < result.rootVisits.size(); ++i)
+        visits[i] += result.rootVisits[i];
+    }
+    const auto best = std::max_element(begin(visits), end(visits));
+    if (best == end(visits) || *best == 0)
+      break;
+    const auto& step = steps[static_cast<std::size_t>(best - begin(visits))];
+    state = solver::apply(step, std::move(state));
+    if (state.hero.isDefeated())
+      return std::nullopt;
+    solution.push_back(step);
+    control.report(static_cast<unsigned>(solution.size()), fitnessRating(state));
+  }
+  return solution;
+}
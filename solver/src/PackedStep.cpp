@@ -0,0 +1,164 @@
+#include "solver/PackedStep.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <type_traits>
+
+static_assert(std::is_trivially_copyable_v<PackedStep> && sizeof(PackedStep) == 2);
+static_assert(std::variant_size_v<Step> <= 16);
+
+namespace
+{
+  template <class... Ts>
+  struct overloaded : Ts...
+  {
+    using Ts::operator()...;
+  };
+
+  template <class... Ts>
+  overloaded(Ts...) -> overloaded<Ts...>;
+
+  template <class T, std::size_t I = 0>
+  constexpr std::uint16_t opcode()
+  {
+    if constexpr (std::is_same_v<T, std::variant_alternative_t<I, Step>>)
+      return static_cast<std::uint16_t>(I);
+    else
+      return opcode<T, I + 1>();
+  }
+
+  constexpr unsigned operandBits = 12;
+  constexpr unsigned operandMask = (1u << operandBits) - 1;
+  // Operand flag to distinguish spells from items (Convert) and pacts from boons (Request)
+  constexpr unsigned alternativeFlag = 1u << 11;
+
+  std::uint16_t encode(std::uint16_t opcode, std::size_t operand)
+  {
+    assert(operand <= operandMask);
+    return static_cast<std::uint16_t>((opcode << operandBits) | operand);
+  }
+
+  template <class Enum>
+  unsigned toOperand(Enum value)
+  {
+    return static_cast<unsigned>(value);
+  }
+
+  // Items use 3 bits for the variant index and 8 bits for the enum value
+  unsigned toOperand(const Item& item)
+  {
+    static_assert(std::variant_size_v<Item> <= 8);
+    const auto value = std::visit([](auto alternative) { return static_cast<unsigned>(alternative); }, item);
+    assert(value < 256);
+    return static_cast<unsigned>(item.index() << 8) | value;
+  }
+
+  Item toItem(unsigned operand)
+  {
+    static_assert(std::variant_size_v<Item> == 7, "Update conversion from operand to Item");
+    const auto value = static_cast<int>(operand & 0xff);
+    switch (operand >> 8)
+    {
+    case 0:
+      return static_cast<BlacksmithItem>(value);
+    case 1:
+      return static_cast<Potion>(value);
+    case 2:
+      return static_cast<AlchemistSeal>(value);
+    case 3:
+      return static_cast<ShopItem>(value);
+    case 4:
+      return static_cast<BossReward>(value);
+    case 5:
+      return static_cast<MiscItem>(value);
+    default:
+      return static_cast<TaurogItem>(value);
+    }
+  }
+} // namespace
+
+PackedStep::PackedStep(const Step& step)
+  : bits(std::visit(
+        overloaded{
+            [](Attack) { return encode(opcode<Attack>(), 0); },
+            [](Cast cast) { return encode(opcode<Cast>(), toOperand(cast.spell)); },
+            [](Uncover uncover) { return encode(opcode<Uncover>(), uncover.numTiles); },
+            [](const Buy& buy) { return encode(opcode<Buy>(), toOperand(buy.item)); },
+            [](const Use& use) { return encode(opcode<Use>(), toOperand(use.item)); },
+            [](const Convert& convert) {
+              if (const auto spell = std::get_if<Spell>(&convert.itemOrSpell))
+                return encode(opcode<Convert>(), alternativeFlag | toOperand(*spell));
+              return encode(opcode<Convert>(), toOperand(std::get<Item>(convert.itemOrSpell)));
+            },
+            [](Find find) { return encode(opcode<Find>(), toOperand(find.spell)); },
+            [](FindFree find) { return encode(opcode<FindFree>(), toOperand(find.spell)); },
+            [](Follow follow) { return encode(opcode<Follow>(), toOperand(follow.deity)); },
+            [](const Request& request) {
+              if (const auto pact = std::get_if<Pact>(&request.boonOrPact))
+                return encode(opcode<Request>(), alternativeFlag | toOperand(*pact));
+              return encode(opcode<Request>(), toOperand(std::get<Boon>(request.boonOrPact)));
+            },
+            [](Desecrate desecrate) { return encode(opcode<Desecrate>(), toOperand(desecrate.altar)); },
+            [](ChangeTarget changeTarget) { return encode(opcode<ChangeTarget>(), changeTarget.targetIndex); },
+            [](NoOp) { return encode(opcode<NoOp>(), 0); }, [](Fight) { return encode(opcode<Fight>(), 0); }},
+        step))
+{
+}
+
+Step PackedStep::unpack() const
+{
+  const unsigned operand = bits & operandMask;
+  const auto value = static_cast<int>(operand & ~alternativeFlag);
+  const bool isAlternative = (operand & alternativeFlag) != 0;
+  switch (bits >> operandBits)
+  {
+  case opcode<Attack>():
+    return Attack{};
+  case opcode<Cast>():
+    return Cast{static_cast<Spell>(value)};
+  case opcode<Uncover>():
+    return Uncover{operand};
+  case opcode<Buy>():
+    return Buy{toItem(operand)};
+  case opcode<Use>():
+    return Use{toItem(operand)};
+  case opcode<Convert>():
+    if (isAlternative)
+      return Convert{static_cast<Spell>(value)};
+    return Convert{toItem(operand)};
+  case opcode<Find>():
+    return Find{static_cast<Spell>(value)};
+  case opcode<FindFree>():
+    return FindFree{static_cast<Spell>(value)};
+  case opcode<Follow>():
+    return Follow{static_cast<God>(value)};
+  case opcode<Request>():
+    if (isAlternative)
+      return Request{static_cast<Pact>(value)};
+    return Request{static_cast<Boon>(value)};
+  case opcode<Desecrate>():
+    return Desecrate{static_cast<God>(value)};
+  case opcode<ChangeTarget>():
+    return ChangeTarget{operand};
+  case opcode<Fight>():
+    return Fight{};
+  default:
+    return NoOp{};
+  }
+}
+
+PackedSolution pack(const Solution& solution)
+{
+  PackedSolution packedSolution(solution.size());
+  std::transform(begin(solution), end(solution), begin(packedSolution),
+                 [](const Step& step) { return PackedStep{step}; });
+  return packedSolution;
+}
+
+Solution unpack(const PackedSolution& packedSolution)
+{
+  Solution solution(packedSolution.size());
+  std::transform(begin(packedSolution), end(packedSolution), begin(solution),
+                 [](PackedStep packedStep) { return packedStep.unpack(); });
+  return solution;
+}
@@ -0,0 +1,140 @@
+#include "solver/Fitness.hpp"
+#include "solver/GameState.hpp"
+#include "solver/Solution.hpp"
+#include "solver/Solver.hpp"
+#include "solver/SolverControl.hpp"
+#include "solver/SolverTools.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace
+{
+  const auto fitnessRating = StateFitnessRating1{};
+
+  // Rating of the state reached by a solution, assuming the worst for all random events
+  int rate(const Solution& solution, GameState state)
+  {
+    state.hero.add(HeroStatus::Pessimist);
+    return fitnessRating(solver::apply(solution, std::move(state)));
+  }
+
+  struct Backend
+  {
+    Solver solver;
+    // Own control per backend, so that all of them can be stopped once one has won
+    std::unique_ptr<SolverControl> control;
+    std::optional<Solution> solution{};
+    int score{fitnessRating.GAME_LOST};
+    bool done{false};
+  };
+
+  SolverCounts operator-(const SolverCounts& a, const SolverCounts& b)
+  {
+    return {.statesApplied = a.statesApplied - b.statesApplied,
+            .invalidSteps = a.invalidSteps - b.invalidSteps,
+            .cacheHits = a.cacheHits - b.cacheHits,
+            .cacheMisses = a.cacheMisses - b.cacheMisses};
+  }
+} // namespace
+
+// Each backend is driven by a thread of its own; their parallel algorithms share the global thread pool.
+// Nodes and counters of the backends are forwarded to `control` periodically, so that its budgets apply to the
+// portfolio as a whole.  If no backend wins, the best rated solution is returned.
+std::optional<Solution> runPortfolio(GameState state, SolverControl& control)
+{
+  std::stop_source stopSource;
+  std::vector<Backend> backends;
+  for (int i = 0; i <= static_cast<int>(Solver::Last); ++i)
+  {
+    const auto solver = static_cast<Solver>(i);
+    if (solver != Solver::Portfolio)
+      backends.push_back(
+          {solver, std::make_unique<SolverControl>(control.subordinateOptions(stopSource.get_token()))});
+  }
+
+  std::mutex mutex;
+  std::condition_variable backendDone;
+  std::optional<std::size_t> winner;
+  std::vector<std::jthread> threads;
+  for (auto& backend : backends)
+  {
+    threads.emplace_back([&] {
+      auto solution = run(backend.solver, state, *backend.control);
+      const auto score = solution ? rate(*solution, state) : fitnessRating.GAME_LOST;
+      std::scoped_lock lock(mutex);
+      backend.solution = std::move(solution);
+      backend.score = score;
+      backend.done = true;
+      if (score == fitnessRating.GAME_WON && !winner)
+      {
+        winner = static_cast<std::size_t>(&backend - backends.data());
+        stopSource.request_stop();
+      }
+      backendDone.notify_all();
+    });
+  }
+
+  std::uint64_t numNodes = 0;
+  SolverCounts counts;
+  unsigned numDone = 0;
+  int bestScore = fitnessRating.GAME_LOST;
+  std::unique_lock lock(mutex);
+  while (numDone < backends.size())
+  {
+    backendDone.wait_for(lock, std::chrono::milliseconds{10});
+    std::uint64_t totalNodes = 0;
+    SolverCounts totalCounts;
+    unsigned totalDone = 0;
+    for (const auto& backend : backends)
+    {
+      const auto metrics = backend.control->getMetrics();
+      totalNodes += metrics.numNodes;
+      totalCounts.statesApplied += metrics.counts.statesApplied;
+      totalCounts.invalidSteps += metrics.counts.invalidSteps;
+      totalCounts.cacheHits += metrics.counts.cacheHits;
+      totalCounts.cacheMisses += metrics.counts.cacheMisses;
+      totalDone += backend.done ? 1 : 0;
+    }
+    control.addNodes(totalNodes - numNodes);
+    control.add(totalCounts - counts);
+    numNodes = totalNodes;
+    counts = totalCounts;
+    if (control.shouldStop())
+      stopSource.request_stop();
+
+    if (totalDone > numDone)
+    {
+      numDone = totalDone;
+      for (const auto& backend : backends)
+      {
+        if (backend.done)
+          bestScore = std::max(bestScore, backend.score);
+      }
+      control.report(numDone, bestScore);
+    }
+  }
+  lock.unlock();
+  threads.clear();
+
+  for (const auto& backend : backends)
+  {
+    control.trace([&] {
+      return TraceEvent{toString(backend.solver), 0, backend.score,
+                        backend.solution ? toString(*backend.solution) : std::string{}};
+    });
+  }
+  if (winner)
+    return backends[*winner].solution;
+  const auto best = std::max_element(begin(backends), end(backends), [](const auto& a, const auto& b) {
+    return std::pair{a.solution.has_value(), a.score} < std::pair{b.solution.has_value(), b.score};
+  });
+  return best->solution;
+}
@@ -36,7 +36,7 @@ namespace
         MonsterType::GooBlob, MonsterType::Gorgon,      MonsterType::MeatMan, MonsterType::Naga,   MonsterType::Serpent,
         MonsterType::Warlock, MonsterType::Wraith,      MonsterType::Zombie};
     auto typeIndex = std::uniform_int_distribution<size_t>{0u, types.size() - 1u};
-    auto generator = std::mt19937{std::random_device{}()};
+    auto& generator = randomGenerator();
     auto level = Level{1};
     Monsters monsters;
     for (auto countPerLevel : {10, 5, 4, 4, 4, 3, 3, 3, 2})
@@ -233,3 +233,17 @@ SimpleResources getResourcesForScenario(Scenario scenario)
   }
   return SimpleResources{{}, 0 /* no hidden tiles */};
 }
+
+GameState initialState(Scenario scenario)
+{
+  return {getHeroForScenario(scenario), getMonstersForScenario(scenario), {}, 0, getResourcesForScenario(scenario)};
+}
+
+GameState simpleFight()
+{
+  GameState state{Hero{HeroClass::Fighter}, {}, {}, 0, SimpleResources{}};
+  state.visibleMonsters.emplace_back(MonsterType::Goblin, Level{1});
+  state.visibleMonsters.emplace_back(MonsterType::Zombie, Level{1});
+  state.resources.numHiddenTiles = 20;
+  return state;
+}
@@ -38,7 +38,8 @@ std::string toString(const Step& step)
       },
       [](Desecrate desecrate) { return "Desecrate "s + toString(desecrate.altar); },
       [](ChangeTarget change) { return "Select target "s + std::to_string(change.targetIndex); },
-      [](NoOp) { return "no-op"s; }
+      [](NoOp) { return "no-op"s; },
+      [](Fight) { return "Fight"s; }
   }, step);
 }
 // clang-format on
@@ -57,5 +58,5 @@ std::string toString(const Solution& solution)
 bool isCombat(const Step& step)
 {
   return step.index() == 0 /* melee attack */
-         || (step.index() == 1 && std::get<1>(step).spell == Spell::Burndayraz);
+         || (step.index() == 1 && std::get<1>(step).spell == Spell::Burndayraz) || std::holds_alternative<Fight>(step);
 }
@@ -1,19 +1,32 @@
 #include "solver/Solver.hpp"
 #include "solver/Fitness.hpp"
+#include "solver/GeneticAlgorithm.hpp"
+#include "solver/MonteCarloTreeSearch.hpp"
+#include "solver/TreeSearch.hpp"
 
-std::optional<Solution> runGeneticAlgorithm(GameState state);
-std::optional<Solution> runTreeSearch(GameState state);
 std::optional<Solution> runHeuristics(GameState state);
+std::optional<Solution> runPortfolio(GameState state, SolverControl& control);
 
-std::optional<Solution> run(Solver solver, GameState initialState)
+std::optional<Solution> run(Solver solver, GameState initialState, SolverOptions options)
 {
+  auto control = SolverControl{std::move(options)};
+  return run(solver, std::move(initialState), control);
+}
+
+std::optional<Solution> run(Solver solver, GameState initialState, SolverControl& control)
+{
+  control.reseed(0);
   switch (solver)
   {
   case Solver::GeneticAlgorithm:
-    return runGeneticAlgorithm(std::move(initialState));
+    return runGeneticAlgorithm(std::move(initialState), control, {.numIslands = control.getNumThreads()});
   case Solver::TreeSearch:
-    return runTreeSearch(std::move(initialState));
+    return runTreeSearch(std::move(initialState), control);
   case Solver::Heuristics:
     return runHeuristics(std::move(initialState));
+  case Solver::MonteCarloTreeSearch:
+    return runMonteCarloTreeSearch(std::move(initialState), control, {.numThreads = control.getNumThreads()});
+  case Solver::Portfolio:
+    return runPortfolio(std::move(initialState), control);
   }
 }
@@ -0,0 +1,106 @@
+#include "solver/SolverControl.hpp"
+
+#include "engine/Random.hpp"
+
+#ifndef _WIN32
+#include <sys/resource.h>
+#endif
+
+namespace
+{
+  std::uint64_t peakMemoryBytes()
+  {
+#ifndef _WIN32
+    rusage usage{};
+    if (getrusage(RUSAGE_SELF, &usage) == 0)
+    {
+#ifdef __APPLE__
+      return static_cast<std::uint64_t>(usage.ru_maxrss);
+#else
+      // Linux reports kilobytes
+      return static_cast<std::uint64_t>(usage.ru_maxrss) * 1024;
+#endif
+    }
+#endif
+    return 0;
+  }
+
+  void addIfNonZero(std::atomic<std::uint64_t>& counter, std::uint64_t numAdded)
+  {
+    if (numAdded > 0)
+      counter.fetch_add(numAdded, std::memory_order_relaxed);
+  }
+} // namespace
+
+SolverControl::SolverControl(SolverOptions options)
+  : options(std::move(options))
+  , start(std::chrono::steady_clock::now())
+  , lastReport(start)
+{
+}
+
+bool SolverControl::shouldStop() const
+{
+  if (options.stopToken.stop_requested())
+    return true;
+  if (options.nodeBudget && getNumNodes() >= *options.nodeBudget)
+    return true;
+  return options.timeBudget && std::chrono::steady_clock::now() - start >= *options.timeBudget;
+}
+
+void SolverControl::add(const SolverCounts& counts)
+{
+  addIfNonZero(statesApplied, counts.statesApplied);
+  addIfNonZero(invalidSteps, counts.invalidSteps);
+  addIfNonZero(cacheHits, counts.cacheHits);
+  addIfNonZero(cacheMisses, counts.cacheMisses);
+}
+
+SolverMetrics SolverControl::getMetrics() const
+{
+  using Seconds = std::chrono::duration<double>;
+  const auto toSeconds = [](std::int64_t ns) { return Seconds{std::chrono::nanoseconds{ns}}.count(); };
+  return {.counts{.statesApplied = statesApplied.load(std::memory_order_relaxed),
+                  .invalidSteps = invalidSteps.load(std::memory_order_relaxed),
+                  .cacheHits = cacheHits.load(std::memory_order_relaxed),
+                  .cacheMisses = cacheMisses.load(std::memory_order_relaxed)},
+          .numNodes = getNumNodes(),
+          .elapsedSeconds = Seconds{std::chrono::steady_clock::now() - start}.count(),
+          .lastIterationSeconds = toSeconds(lastIterationNs.load(std::memory_order_relaxed)),
+          .maxIterationSeconds = toSeconds(maxIterationNs.load(std::memory_order_relaxed)),
+          .peakMemoryBytes = peakMemoryBytes()};
+}
+
+void SolverControl::report(unsigned iteration, int bestScore, unsigned depth)
+{
+  const auto now = std::chrono::steady_clock::now();
+  const auto iterationNs = std::chrono::duration_cast<std::chrono::nanoseconds>(now - lastReport).count();
+  lastReport = now;
+  lastIterationNs.store(iterationNs, std::memory_order_relaxed);
+  if (iterationNs > maxIterationNs.load(std::memory_order_relaxed))
+    maxIterationNs.store(iterationNs, std::memory_order_relaxed);
+
+  if (!options.onProgress)
+    return;
+  const auto seconds = std::chrono::duration<double>(now - start).count();
+  const auto nodes = getNumNodes();
+  options.onProgress({.iteration = iteration,
+                      .bestScore = bestScore,
+                      .depth = depth,
+                      .numNodes = nodes,
+                      .nodesPerSecond = seconds > 0 ? static_cast<double>(nodes) / seconds : 0});
+}
+
+SolverOptions SolverControl::subordinateOptions(std::stop_token stopToken) const
+{
+  return {.stopToken = std::move(stopToken),
+          .numThreads = options.numThreads,
+          .seed = options.seed,
+          .traceSink = options.traceSink};
+}
+
+void SolverControl::reseed(std::uint64_t stream) const
+{
+  if (options.seed)
+    seedRandomGenerator(RandomGenerator{*options.seed ^ (stream * 0x9e3779b97f4a7c15ull)}());
+}
@@ -0,0 +1,66 @@
+#include "solver/SolverJob.hpp"
+
+#include <cassert>
+
+SolverJob::SolverJob(Solver solver, GameState initialState, SolverOptions options)
+  : control([this, &options] {
+    auto onProgress = std::move(options.onProgress);
+    options.onProgress = [this, onProgress = std::move(onProgress)](const SolverProgress& newProgress) {
+      {
+        std::scoped_lock lock(mutex);
+        progress = newProgress;
+      }
+      if (onProgress)
+        onProgress(newProgress);
+    };
+    options.stopToken = stopSource.get_token();
+    return std::move(options);
+  }())
+  , thread([this, solver, initialState = std::move(initialState)]() mutable {
+    auto solution = run(solver, std::move(initialState), control);
+    {
+      std::scoped_lock lock(mutex);
+      result = std::move(solution);
+    }
+    done = true;
+  })
+{
+}
+
+SolverJob::~SolverJob()
+{
+  cancel();
+}
+
+void SolverJob::cancel()
+{
+  stopSource.request_stop();
+}
+
+bool SolverJob::isCancelled() const
+{
+  return stopSource.stop_requested();
+}
+
+bool SolverJob::isDone() const
+{
+  return done;
+}
+
+SolverProgress SolverJob::getProgress() const
+{
+  std::scoped_lock lock(mutex);
+  return progress;
+}
+
+SolverMetrics SolverJob::getMetrics() const
+{
+  return control.getMetrics();
+}
+
+std::optional<Solution> SolverJob::getResult() const
+{
+  assert(isDone());
+  std::scoped_lock lock(mutex);
+  return result;
+}
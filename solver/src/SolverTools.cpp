@@ -2,256 +2,30 @@
 
 #include "engine/Combat.hpp"
 #include "engine/Magic.hpp"
+#include "solver/ValidSteps.hpp"
 
 #include <cassert>
 #include <iostream>
 #include <numeric>
-#include <random>
+#include <tuple>
 #include <variant>
 
 namespace solver
 {
-  thread_local std::mt19937 generator{std::random_device{"/dev/urandom"}()};
-
-  Step generateValidStep(const GameState& state, int stepTypeIndex)
-  {
-    auto otherAltar = [&hero = state.hero, altars = state.resources.altars]() mutable -> std::optional<God> {
-      altars.erase(std::remove(begin(altars), end(altars), GodOrPactmaker{Pactmaker::ThePactmaker}), end(altars));
-      if (altars.empty())
-        return {};
-      std::shuffle(begin(altars), end(altars), generator);
-      if (!hero.getFollowedDeity())
-        return std::get<God>(altars.front());
-      auto altarIt =
-          std::find_if(begin(altars), end(altars), [followedDeity = *hero.getFollowedDeity()](const auto altar) {
-            return altar != GodOrPactmaker{followedDeity};
-          });
-      if (altarIt != end(altars))
-        return std::get<God>(*altarIt);
-      return {};
-    };
-
-    auto randomElement = [](const auto& vec) {
-      assert(!vec.empty());
-      const auto index = std::uniform_int_distribution<std::size_t>(0, vec.size() - 1u)(generator);
-      return vec[index];
-    };
-
-    switch (stepTypeIndex)
-    {
-    case 0:
-      assert(state.activeMonster < state.visibleMonsters.size());
-      return Attack{};
-    case 1:
-    {
-      assert(state.activeMonster < state.visibleMonsters.size());
-      auto spellCounts = state.hero.getSpellCounts();
-      std::shuffle(begin(spellCounts), end(spellCounts), generator);
-      const auto spellIt =
-          std::find_if(begin(spellCounts), end(spellCounts),
-                       [&state, &monster = state.visibleMonsters[state.activeMonster]](const auto& spellCount) {
-                         const Spell spell = spellCount.first;
-                         return Magic::isPossible(state.hero, monster, spell, state.resources);
-                       });
-      if (spellIt != end(spellCounts))
-        return Cast{spellIt->first};
-      break;
-    }
-    case 2:
-      if (state.resources.numHiddenTiles > 0)
-        return Uncover{1};
-      break;
-    case 3:
-    {
-      if (!state.hero.hasRoomFor(Potion::HealthPotion) || state.hero.gold() == 0)
-        break;
-      auto shops = state.resources.shops;
-      std::shuffle(begin(shops), end(shops), generator);
-      const auto shopIt = std::find_if(begin(shops), end(shops), [&hero = state.hero](const Item item) {
-        return hero.hasRoomFor(item) && hero.canAfford(item);
-      });
-      if (shopIt != end(shops))
-        return Buy{*shopIt};
-      break;
-    }
-    case 4:
-    {
-      auto itemCounts = state.hero.getItemCounts();
-      std::shuffle(begin(itemCounts), end(itemCounts), generator);
-      const auto itemIt = std::find_if(begin(itemCounts), end(itemCounts), [&hero = state.hero](const auto& itemCount) {
-        return hero.canUse(itemCount.first);
-      });
-      if (itemIt != end(itemCounts))
-        return Use{itemIt->first};
-      break;
-    }
-    case 5:
-    {
-      const auto& entries = state.hero.getItemsAndSpells();
-      if (!entries.empty())
-      {
-        if (const auto& entry = randomElement(entries); entry.conversionPoints >= 0)
-          return Convert{entry.itemOrSpell};
-        // few items cannot be converted, do not retry here
-      }
-      break;
-    }
-    case 6:
-      if (!state.resources.spells.empty() && state.hero.hasRoomFor(Spell::Burndayraz))
-        return Find{randomElement(state.resources.spells)};
-      break;
-    case 7:
-      if (!state.resources.freeSpells.empty() && state.hero.hasRoomFor(Spell::Burndayraz))
-        return FindFree{randomElement(state.resources.freeSpells)};
-      break;
-    case 8:
-    {
-      if (state.resources.altars.empty() || (state.hero.getFollowedDeity() && state.hero.getPiety() < 50))
-        break;
-      if (const auto altar = otherAltar())
-        return Follow{*altar};
-      break;
-    }
-    case 9:
-      if (state.hero.getFollowedDeity())
-      {
-        auto boons = offeredBoons(*state.hero.getFollowedDeity());
-        std::shuffle(begin(boons), end(boons), generator);
-        auto boonIt = std::find_if(begin(boons), end(boons), [&state, &faith = state.hero.getFaith()](Boon boon) {
-          return static_cast<int>(faith.getPiety()) >= faith.getCosts(boon, state.hero) &&
-                 faith.isAvailable(boon, state.hero, state.visibleMonsters, state.resources);
-        });
-        if (boonIt != end(boons))
-          return Request{*boonIt};
-      }
-      break;
-    case 10:
-      if (state.resources.pactmakerAvailable() && !state.hero.getFaith().getPact())
-      {
-        const auto last = state.hero.getFaith().enteredConsensus() ? Pact::LastNoConsensus : Pact::LastWithConsensus;
-        return Request{static_cast<Pact>(std::uniform_int_distribution<>(0, static_cast<int>(last) - 1)(generator))};
-      }
-      break;
-    case 11:
-      if (state.hero.getFollowedDeity() && !state.resources.altars.empty() && !state.hero.has(HeroTrait::Scapegoat))
-      {
-        if (const auto altar = otherAltar())
-          return Desecrate{*altar};
-      }
-      break;
-    case 12:
-    {
-      const auto numMonsters = state.visibleMonsters.size();
-      if (numMonsters > 1)
-      {
-        auto newTargetIndex = std::uniform_int_distribution<std::size_t>(0u, numMonsters - 2)(generator);
-        if (newTargetIndex == state.activeMonster)
-          newTargetIndex = (newTargetIndex + 1) % numMonsters;
-        return ChangeTarget{newTargetIndex};
-      }
-    }
-    }
-    return NoOp{};
-  }
-
   Step generateRandomValidStep(const GameState& state, bool allowTargetChange)
   {
     // Rely on at least one monster being present
     assert(state.activeMonster < state.visibleMonsters.size());
-    std::uniform_int_distribution<> randomAction(0, allowTargetChange ? 12 : 11);
-
-    while (true)
-    {
-      auto step = generateValidStep(state, randomAction(generator));
-      if (!std::holds_alternative<NoOp>(step))
-        return step;
-    }
+    return ValidSteps{state, allowTargetChange}.random();
   }
 
   std::vector<Step> generateAllValidSteps(const GameState& state, bool allowTargetChange)
   {
+    const ValidSteps validSteps{state, allowTargetChange};
     std::vector<Step> steps;
-    steps.emplace_back(Attack{});
-    if (state.resources.numHiddenTiles > 0)
-      steps.emplace_back(Uncover{1});
-    const auto& hero = state.hero;
-    const auto& monsters = state.visibleMonsters;
-    const bool hasMonster = state.activeMonster < monsters.size();
-    for (auto& entry : hero.getItemsAndSpells())
-    {
-      if (const auto spell = std::get_if<Spell>(&entry.itemOrSpell))
-      {
-        if ((!Magic::needsMonster(*spell) && Magic::isPossible(hero, *spell, state.resources)) ||
-            (hasMonster && Magic::isPossible(hero, monsters[state.activeMonster], *spell, state.resources)))
-          steps.emplace_back(Cast{*spell});
-      }
-      else if (const auto item = std::get<Item>(entry.itemOrSpell); hero.canUse(item))
-        steps.emplace_back(Use{item});
-      if (entry.conversionPoints >= 0)
-        steps.emplace_back(Convert{entry.itemOrSpell});
-    }
-    for (const auto& item : state.resources.shops)
-    {
-      if (hero.hasRoomFor(item) && hero.canAfford(item))
-        steps.emplace_back(Buy{item});
-    }
-    if (hero.hasRoomFor(Spell::Burndayraz))
-    {
-      for (const auto& spell : state.resources.spells)
-        steps.emplace_back(Find{spell});
-      for (const auto& spell : state.resources.freeSpells)
-        steps.emplace_back(FindFree{spell});
-    }
-    const auto& faith = hero.getFaith();
-    if (state.resources.pactmakerAvailable() && !faith.getPact())
-    {
-      for (int i = 0; i < static_cast<int>(Pact::LastNoConsensus); ++i)
-        steps.emplace_back(Request{static_cast<Pact>(i)});
-      if (!faith.enteredConsensus())
-        steps.emplace_back(Request{Pact::Consensus});
-    }
-    if (state.hero.getFollowedDeity())
-    {
-      for (const auto boon : offeredBoons(*state.hero.getFollowedDeity()))
-      {
-        const auto costs = hero.getBoonCosts(boon);
-        if ((costs <= 0 || hero.getPiety() >= static_cast<unsigned>(costs)) &&
-            faith.isAvailable(boon, hero, monsters, state.resources))
-          steps.emplace_back(Request{boon});
-      }
-      const bool canConvert = faith.getPiety() >= 50;
-      const bool canDesecrate = !hero.has(HeroTrait::Scapegoat);
-      if (canConvert || canDesecrate)
-      {
-        for (const auto& altar : state.resources.altars)
-        {
-          if (const auto god = std::get_if<God>(&altar); god && *god != state.hero.getFollowedDeity())
-          {
-            if (canConvert)
-              steps.emplace_back(Follow{*god});
-            if (canDesecrate)
-              steps.emplace_back(Desecrate{*god});
-          }
-        }
-      }
-    }
-    else
-    {
-      for (const auto& altar : state.resources.altars)
-      {
-        if (const auto god = std::get_if<God>(&altar))
-          steps.emplace_back(Follow{*god});
-      }
-    }
-    if (allowTargetChange)
-    {
-      for (auto monsterIndex = 0u; monsterIndex < monsters.size(); ++monsterIndex)
-      {
-        if (monsterIndex != state.activeMonster)
-          steps.emplace_back(ChangeTarget{monsterIndex});
-      }
-    }
-
+    steps.reserve(validSteps.size());
+    for (const auto step : validSteps)
+      steps.emplace_back(step.unpack());
     return steps;
   }
 
@@ -299,55 +73,180 @@ namespace solver
                             std::find(begin(altars), end(altars), GodOrPactmaker{desecrate.altar}) != end(altars);
                    },
                    [&](ChangeTarget changeTarget) { return changeTarget.targetIndex < monsters.size(); },
-                   [](NoOp) { return true; }},
+                   [](NoOp) { return true; }, [&](Fight) { return continuesFight(state); }},
         step);
   }
 
+  bool continuesFight(const GameState& state)
+  {
+    if (state.activeMonster >= state.visibleMonsters.size() || state.hero.isDefeated())
+      return false;
+    const auto& hero = state.hero;
+    const auto& monster = state.visibleMonsters[state.activeMonster];
+    if (monster.isDefeated())
+      return false;
+    const auto monsterDies =
+        !monster.getDeathProtection() &&
+        monster.predictDamageTaken(hero.getDamageOutputVersus(monster), hero.damageType()) >= monster.getHitPoints();
+    const auto heroWillBeHit = !hero.hasInitiativeVersus(monster) || !monsterDies;
+    return !heroWillBeHit ||
+           hero.predictDamageTaken(monster.getDamage(), monster.damageType()) < hero.getHitPoints();
+  }
+
+  namespace
+  {
+    void applyImpl(const Step& step, GameState& state);
+
+    // Apply the attacks of a Fight, each like an Attack step, and call onAttack after each of them.  The fight ends
+    // early once any monster is defeated or an attack makes no progress, e.g. if the hero cannot damage the target.
+    template <class OnAttack>
+    void fight(GameState& state, OnAttack onAttack)
+    {
+      auto& monsters = state.visibleMonsters;
+      do
+      {
+        const auto& target = monsters[state.activeMonster];
+        const auto before = std::tuple{monsters.size(), target.getHitPoints(), target.getDeathProtection()};
+        applyImpl(Attack{}, state);
+        onAttack();
+        if (monsters.size() != std::get<0>(before))
+          return;
+        const auto& after = monsters[state.activeMonster];
+        if (std::tuple{monsters.size(), after.getHitPoints(), after.getDeathProtection()} == before)
+          return;
+      } while (continuesFight(state));
+    }
+
+    void applyImpl(const Step& step, GameState& state)
+    {
+      auto& monsters = state.visibleMonsters;
+      if (state.activeMonster >= monsters.size())
+        return;
+      auto& hero = state.hero;
+      auto& monster = monsters[state.activeMonster];
+      std::visit(overloaded{[&](Attack) { Combat::attack(hero, monster, monsters, state.resources); },
+                            [&](Cast cast) { Magic::cast(hero, monster, cast.spell, monsters, state.resources); },
+                            [&](Uncover uncover) {
+                              hero.recover(uncover.numTiles, monsters);
+                              monster.recover(uncover.numTiles);
+                              state.resources.numHiddenTiles -= uncover.numTiles;
+                            },
+                            [&hero, &shops = state.resources.shops](Buy buy) {
+                              shops.erase(std::find(begin(shops), end(shops), buy.item));
+                              hero.buy(buy.item);
+                            },
+                            [&](Use use) { hero.use(use.item, monsters); },
+                            [&](Convert convert) { hero.convert(convert.itemOrSpell, monsters); },
+                            [&hero, &spells = state.resources.spells](Find find) {
+                              if (hero.receive(find.spell))
+                                spells.erase(std::find(begin(spells), end(spells), find.spell));
+                            },
+                            [&hero, &spells = state.resources.freeSpells](FindFree find) {
+                              if (hero.receiveFreeSpell(find.spell))
+                                spells.erase(std::find(begin(spells), end(spells), find.spell));
+                            },
+                            [&](Follow follow) {
+                              hero.followDeity(follow.deity, state.resources.numRevealedTiles, state.resources);
+                            },
+                            [&](Request request) { hero.request(request.boonOrPact, monsters, state.resources); },
+                            [&hero, &monsters, &altars = state.resources.altars](Desecrate desecrate) {
+                              if (hero.desecrate(desecrate.altar, monsters))
+                                altars.erase(std::find(begin(altars), end(altars), GodOrPactmaker{desecrate.altar}));
+                            },
+                            [&state](ChangeTarget changeTarget) { state.activeMonster = changeTarget.targetIndex; },
+                            [](NoOp) {}, [&state](Fight) { fight(state, [] {}); }},
+                 step);
+      monsters.erase(
+          std::remove_if(begin(monsters), end(monsters), [](const auto& monster) { return monster.isDefeated(); }),
+          end(monsters));
+      if (state.activeMonster > monsters.size())
+        state.activeMonster = 0u;
+    }
+  } // namespace
+
   GameState apply(const Step& step, GameState state)
   {
-    auto& monsters = state.visibleMonsters;
-    if (state.activeMonster >= monsters.size())
-      return state;
-    auto& hero = state.hero;
-    auto& monster = monsters[state.activeMonster];
-    std::visit(overloaded{[&](Attack) { Combat::attack(hero, monster, monsters, state.resources); },
-                          [&](Cast cast) { Magic::cast(hero, monster, cast.spell, monsters, state.resources); },
-                          [&](Uncover uncover) {
-                            hero.recover(uncover.numTiles, monsters);
-                            monster.recover(uncover.numTiles);
-                            state.resources.numHiddenTiles -= uncover.numTiles;
-                          },
-                          [&hero, &shops = state.resources.shops](Buy buy) {
-                            shops.erase(std::find(begin(shops), end(shops), buy.item));
-                            hero.buy(buy.item);
-                          },
-                          [&](Use use) { hero.use(use.item, monsters); },
-                          [&](Convert convert) { hero.convert(convert.itemOrSpell, monsters); },
-                          [&hero, &spells = state.resources.spells](Find find) {
-                            if (hero.receive(find.spell))
-                              spells.erase(std::find(begin(spells), end(spells), find.spell));
+    applyImpl(step, state);
+    return state;
+  }
+
+  UndoRecord applyInPlace(const Step& step, GameState& state)
+  {
+    auto& resources = state.resources;
+    UndoRecord undo{.activeMonster = state.activeMonster, .numHiddenTiles = resources.numHiddenTiles};
+    if (state.activeMonster >= state.visibleMonsters.size())
+      return undo;
+
+    const auto indexOf = [](const auto& container, const auto& value) -> std::optional<std::size_t> {
+      const auto it = std::find(begin(container), end(container), value);
+      if (it == end(container))
+        return std::nullopt;
+      return static_cast<std::size_t>(std::distance(begin(container), it));
+    };
+
+    // Record everything that the step may modify; entries are only removed from resource lists if successful
+    const auto save = [&](bool monsters, bool allResources) {
+      undo.hero = state.hero;
+      if (monsters)
+        undo.monsters = state.visibleMonsters;
+      if (allResources)
+        undo.resources = resources;
+    };
+    std::visit(overloaded{[&](Attack) { save(true, true); }, [&](Cast) { save(true, true); },
+                          [&](Uncover) { save(true, false); },
+                          [&](Buy buy) {
+                            save(false, false);
+                            undo.removedIndex = indexOf(resources.shops, buy.item);
                           },
-                          [&hero, &spells = state.resources.freeSpells](FindFree find) {
-                            if (hero.receiveFreeSpell(find.spell))
-                              spells.erase(std::find(begin(spells), end(spells), find.spell));
+                          [&](Use) { save(true, false); }, [&](Convert) { save(true, false); },
+                          [&](Find find) {
+                            save(false, false);
+                            undo.removedIndex = indexOf(resources.spells, find.spell);
                           },
-                          [&](Follow follow) {
-                            hero.followDeity(follow.deity, state.resources.numRevealedTiles, state.resources);
+                          [&](FindFree find) {
+                            save(false, false);
+                            undo.removedIndex = indexOf(resources.freeSpells, find.spell);
                           },
-                          [&](Request request) { hero.request(request.boonOrPact, monsters, state.resources); },
-                          [&hero, &monsters, &altars = state.resources.altars](Desecrate desecrate) {
-                            if (hero.desecrate(desecrate.altar, monsters))
-                              altars.erase(std::find(begin(altars), end(altars), GodOrPactmaker{desecrate.altar}));
+                          [&](Follow) { save(false, true); }, [&](Request) { save(true, true); },
+                          [&](Desecrate desecrate) {
+                            save(true, false);
+                            undo.removedIndex = indexOf(resources.altars, GodOrPactmaker{desecrate.altar});
                           },
-                          [&state](ChangeTarget changeTarget) { state.activeMonster = changeTarget.targetIndex; },
-                          [](NoOp) {}},
+                          [](ChangeTarget) {}, [](NoOp) {}, [&](Fight) { save(true, true); }},
+               step);
+
+    const auto numResourcesBefore =
+        resources.shops.size() + resources.spells.size() + resources.freeSpells.size() + resources.altars.size();
+    applyImpl(step, state);
+    if (numResourcesBefore ==
+        resources.shops.size() + resources.spells.size() + resources.freeSpells.size() + resources.altars.size())
+      undo.removedIndex.reset();
+    return undo;
+  }
+
+  void unapply(const Step& step, UndoRecord undo, GameState& state)
+  {
+    auto& resources = state.resources;
+    state.activeMonster = undo.activeMonster;
+    if (undo.hero)
+      state.hero = std::move(*undo.hero);
+    if (undo.monsters)
+      state.visibleMonsters = std::move(*undo.monsters);
+    if (undo.resources)
+      resources = std::move(*undo.resources);
+    resources.numHiddenTiles = undo.numHiddenTiles;
+    if (!undo.removedIndex)
+      return;
+    const auto reinsert = [index = *undo.removedIndex](auto& container, auto value) {
+      assert(index <= container.size());
+      container.insert(begin(container) + static_cast<std::ptrdiff_t>(index), std::move(value));
+    };
+    std::visit(overloaded{[&](Buy buy) { reinsert(resources.shops, buy.item); },
+                          [&](Find find) { reinsert(resources.spells, find.spell); },
+                          [&](FindFree find) { reinsert(resources.freeSpells, find.spell); },
+                          [&](Desecrate desecrate) { reinsert(resources.altars, GodOrPactmaker{desecrate.altar}); },
+                          [](const auto&) { assert(false); }},
                step);
-    monsters.erase(
-        std::remove_if(begin(monsters), end(monsters), [](const auto& monster) { return monster.isDefeated(); }),
-        end(monsters));
-    if (state.activeMonster > monsters.size())
-      state.activeMonster = 0u;
-    return state;
   }
 
   GameState apply(const Solution& solution, GameState state)
@@ -357,6 +256,27 @@ namespace solver
     return state;
   }
 
+  Solution expandMacros(const Solution& solution, GameState state)
+  {
+    Solution expanded;
+    expanded.reserve(solution.size());
+    for (const auto& step : solution)
+    {
+      if (std::holds_alternative<Fight>(step))
+      {
+        if (state.activeMonster < state.visibleMonsters.size())
+          fight(state, [&expanded] { expanded.emplace_back(Attack{}); });
+        continue;
+      }
+      if (const auto uncover = std::get_if<Uncover>(&step))
+        expanded.insert(end(expanded), uncover->numTiles, Uncover{1});
+      else
+        expanded.push_back(step);
+      applyImpl(step, state);
+    }
+    return expanded;
+  }
+
   namespace
   {
     void print_description(const std::vector<std::string>& description)
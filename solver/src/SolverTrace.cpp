@@ -0,0 +1,53 @@
+#include "solver/SolverTrace.hpp"
+
+#include <algorithm>
+
+namespace
+{
+  std::string quoted(const std::string& text)
+  {
+    std::string result{'"'};
+    for (const char c : text)
+    {
+      if (c == '"' || c == '\\')
+        result += '\\';
+      if (c == '\n')
+        result += "\\n";
+      else
+        result += c;
+    }
+    return result + '"';
+  }
+} // namespace
+
+JsonLinesTraceSink::JsonLinesTraceSink(const std::string& path)
+  : out(path)
+{
+}
+
+void JsonLinesTraceSink::write(const TraceEvent& event)
+{
+  std::scoped_lock lock(mutex);
+  out << "{\"type\": " << quoted(event.type) << ", \"iteration\": " << event.iteration
+      << ", \"score\": " << event.score << ", \"seconds\": " << event.seconds
+      << ", \"solution\": " << quoted(event.solution) << ", \"details\": " << quoted(event.details) << "}\n";
+}
+
+RingBufferTraceSink::RingBufferTraceSink(std::size_t capacity)
+  : capacity(std::max(capacity, std::size_t{1}))
+{
+}
+
+void RingBufferTraceSink::write(const TraceEvent& event)
+{
+  std::scoped_lock lock(mutex);
+  if (events.size() == capacity)
+    events.pop_front();
+  events.push_back(event);
+}
+
+std::vector<TraceEvent> RingBufferTraceSink::getEvents() const
+{
+  std::scoped_lock lock(mutex);
+  return {begin(events), end(events)};
+}
@@ -0,0 +1,205 @@
+#include "solver/StateHash.hpp"
+
+#include <numeric>
+
+namespace solver
+{
+  namespace
+  {
+    enum class Feature : std::uint64_t
+    {
+      HeroHitPoints,
+      HeroHitPointsMax,
+      HeroManaPoints,
+      HeroManaPointsMax,
+      HeroBaseDamage,
+      HeroDamageBonus,
+      HeroPhysicalResist,
+      HeroMagicalResist,
+      HeroLevel,
+      HeroXP,
+      HeroGold,
+      HeroConversionPoints,
+      HeroFood,
+      HeroDodgeChance,
+      HeroStatus,
+      HeroDebuff,
+      Piety,
+      FollowedDeity,
+      Pact,
+      Consensus,
+      Boon,
+      InventoryEntry,
+      MonsterIdentity,
+      MonsterHitPoints,
+      MonsterHitPointsMax,
+      MonsterDamage,
+      MonsterResists,
+      MonsterStatus,
+      MonsterTraits,
+      VisibleMonster,
+      MonsterHistory,
+      ActiveMonster,
+      HiddenTiles,
+      Walls,
+      Plants,
+      BloodPools,
+      Shop,
+      Spell,
+      FreeSpell,
+      Altar,
+    };
+
+    // splitmix64 finalizer; stands in for a table of random Zobrist keys indexed by feature and value
+    constexpr std::uint64_t mix(std::uint64_t x)
+    {
+      x += 0x9e3779b97f4a7c15ull;
+      x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ull;
+      x = (x ^ (x >> 27)) * 0x94d049bb133111ebull;
+      return x ^ (x >> 31);
+    }
+
+    constexpr std::uint64_t key(Feature feature, std::uint64_t value)
+    {
+      return mix((static_cast<std::uint64_t>(feature) << 56) ^ mix(value));
+    }
+
+    constexpr std::uint64_t key(Feature feature, std::uint64_t index, std::uint64_t value)
+    {
+      return mix(key(feature, index) ^ value);
+    }
+
+    std::uint64_t toNumber(const Item& item)
+    {
+      return std::visit(
+          [index = item.index()](auto value) { return (index << 16) | static_cast<std::uint64_t>(value); }, item);
+    }
+
+    std::uint64_t toNumber(const ItemOrSpell& itemOrSpell)
+    {
+      if (const auto item = std::get_if<Item>(&itemOrSpell))
+        return toNumber(*item);
+      return (1ull << 32) | static_cast<std::uint64_t>(std::get<Spell>(itemOrSpell));
+    }
+
+    std::uint64_t toNumber(const GodOrPactmaker& altar)
+    {
+      if (const auto god = std::get_if<God>(&altar))
+        return static_cast<std::uint64_t>(*god);
+      return 1ull << 32;
+    }
+
+    // Order-independent combination of the keys of all elements in a collection
+    template <class Container, class Projection>
+    std::uint64_t unorderedKeys(Feature feature, const Container& container, Projection projection)
+    {
+      return std::transform_reduce(begin(container), end(container), std::uint64_t{0}, std::plus<>(),
+                                   [&](const auto& element) { return key(feature, projection(element)); });
+    }
+  } // namespace
+
+  std::uint64_t hash(const Hero& hero)
+  {
+    auto h = key(Feature::HeroHitPoints, hero.getHitPoints()) ^ key(Feature::HeroHitPointsMax, hero.getHitPointsMax()) ^
+             key(Feature::HeroManaPoints, hero.getManaPoints()) ^
+             key(Feature::HeroManaPointsMax, hero.getManaPointsMax()) ^
+             key(Feature::HeroBaseDamage, hero.getBaseDamage()) ^
+             key(Feature::HeroDamageBonus, static_cast<std::uint64_t>(hero.getDamageBonusPercent())) ^
+             key(Feature::HeroPhysicalResist, static_cast<std::uint64_t>(hero.getPhysicalResistPercent())) ^
+             key(Feature::HeroMagicalResist, static_cast<std::uint64_t>(hero.getMagicalResistPercent())) ^
+             key(Feature::HeroLevel, hero.getLevel()) ^ key(Feature::HeroXP, hero.getXP()) ^
+             key(Feature::HeroGold, hero.gold()) ^ key(Feature::HeroConversionPoints, hero.getConversionPoints()) ^
+             key(Feature::HeroFood, hero.getFoodCount()) ^
+             key(Feature::HeroDodgeChance, hero.getDodgeChancePercent());
+
+    for (int i = 0; i <= static_cast<int>(HeroStatus::ByssepsStacks); ++i)
+    {
+      if (const auto intensity = hero.getIntensity(static_cast<HeroStatus>(i)))
+        h ^= key(Feature::HeroStatus, static_cast<std::uint64_t>(i), intensity);
+    }
+    for (int i = 0; i <= static_cast<int>(HeroDebuff::Last); ++i)
+    {
+      if (const auto intensity = hero.getIntensity(static_cast<HeroDebuff>(i)))
+        h ^= key(Feature::HeroDebuff, static_cast<std::uint64_t>(i), intensity);
+    }
+
+    const auto& faith = hero.getFaith();
+    h ^= key(Feature::Piety, faith.getPiety());
+    if (const auto deity = faith.getFollowedDeity())
+      h ^= key(Feature::FollowedDeity, static_cast<std::uint64_t>(*deity));
+    if (const auto pact = faith.getPact())
+      h ^= key(Feature::Pact, static_cast<std::uint64_t>(*pact));
+    if (faith.enteredConsensus())
+      h ^= key(Feature::Consensus, 1);
+    for (int i = 0; i <= static_cast<int>(Boon::Last); ++i)
+    {
+      if (const auto count = faith.boonCount(static_cast<Boon>(i)))
+        h ^= key(Feature::Boon, static_cast<std::uint64_t>(i), count);
+    }
+
+    h ^= unorderedKeys(Feature::InventoryEntry, hero.getItemsAndSpells(), [](const Inventory::Entry& entry) {
+      return mix(toNumber(entry.itemOrSpell)) ^ (static_cast<std::uint64_t>(entry.isSmall) << 63) ^
+             (static_cast<std::uint64_t>(static_cast<std::uint32_t>(entry.price)) << 20) ^
+             static_cast<std::uint64_t>(static_cast<std::uint32_t>(entry.conversionPoints));
+    });
+    return h;
+  }
+
+  std::uint64_t hash(const Monster& monster)
+  {
+    std::uint64_t traits = 0;
+    for (int i = 0; i <= static_cast<int>(MonsterTrait::Last); ++i)
+    {
+      if (monster.has(static_cast<MonsterTrait>(i)))
+        traits |= 1ull << i;
+    }
+    const std::uint64_t status = static_cast<std::uint64_t>(monster.getBurnStackSize()) |
+                                 (static_cast<std::uint64_t>(monster.getPoisonAmount()) << 8) |
+                                 (static_cast<std::uint64_t>(monster.getCorroded()) << 24) |
+                                 (static_cast<std::uint64_t>(monster.getDeathProtection()) << 40) |
+                                 (static_cast<std::uint64_t>(monster.isSlowed()) << 48) |
+                                 (static_cast<std::uint64_t>(monster.isZotted()) << 49) |
+                                 (static_cast<std::uint64_t>(monster.isWickedSick()) << 50);
+    return key(Feature::MonsterIdentity, (static_cast<std::uint64_t>(monster.getLevel()) << 8) |
+                                             static_cast<std::uint64_t>(monster.damageType())) ^
+           key(Feature::MonsterHitPoints, monster.getHitPoints()) ^
+           key(Feature::MonsterHitPointsMax, monster.getHitPointsMax()) ^
+           key(Feature::MonsterDamage, monster.getDamage()) ^
+           key(Feature::MonsterResists, (monster.getPhysicalResistPercent() << 8) | monster.getMagicalResistPercent()) ^
+           key(Feature::MonsterStatus, status) ^ key(Feature::MonsterTraits, traits);
+  }
+
+  std::uint64_t hash(const SimpleResources& resources)
+  {
+    return key(Feature::HiddenTiles, resources.numHiddenTiles) ^ key(Feature::Walls, resources.numWalls) ^
+           key(Feature::Plants, resources.numPlants) ^ key(Feature::BloodPools, resources.numBloodPools) ^
+           unorderedKeys(Feature::Shop, resources.shops, [](const Item& item) { return toNumber(item); }) ^
+           unorderedKeys(Feature::Spell, resources.spells,
+                         [](Spell spell) { return static_cast<std::uint64_t>(spell); }) ^
+           unorderedKeys(Feature::FreeSpell, resources.freeSpells,
+                         [](Spell spell) { return static_cast<std::uint64_t>(spell); }) ^
+           unorderedKeys(Feature::Altar, resources.altars, [](const GodOrPactmaker& altar) { return toNumber(altar); });
+  }
+
+  std::uint64_t hash(const GameState& state)
+  {
+    auto h = hash(state.hero) ^ hash(state.resources) ^ key(Feature::ActiveMonster, state.activeMonster);
+    const auto& monsters = state.visibleMonsters;
+    const auto& faith = state.hero.getFaith();
+    for (std::size_t i = 0; i < monsters.size(); ++i)
+    {
+      h ^= key(Feature::VisibleMonster, i, hash(monsters[i]));
+      // Piety awarded later by Dracul and Tikki Tooki depends on what happened with the monster before
+      if (const auto history = faith.getMonsterHistory(monsters[i].getID()))
+        h ^= key(Feature::MonsterHistory, i, history);
+    }
+    return h;
+  }
+
+  std::uint64_t quantityHash(const GameState& state)
+  {
+    return key(Feature::HeroHitPoints, state.hero.getHitPoints()) ^
+           key(Feature::HeroManaPoints, state.hero.getManaPoints()) ^ key(Feature::HeroGold, state.hero.gold()) ^
+           key(Feature::HiddenTiles, state.resources.numHiddenTiles);
+  }
+} // namespace solver
@@ -0,0 +1,41 @@
+#include "solver/TranspositionTable.hpp"
+
+#include <bit>
+#include <cassert>
+
+namespace solver
+{
+  TranspositionTable::TranspositionTable(std::size_t numEntries)
+    : entries(std::bit_ceil(std::max(numEntries, std::size_t{1})))
+  {
+  }
+
+  std::optional<TranspositionTable::Entry> TranspositionTable::lookup(std::uint64_t hash, int minDepth) const
+  {
+    const auto i = index(hash);
+    std::scoped_lock lock(lockFor(i));
+    const auto& entry = entries[i];
+    if (entry.hash == hash && entry.depth >= minDepth)
+      return entry;
+    return std::nullopt;
+  }
+
+  void TranspositionTable::store(Entry entry)
+  {
+    assert(entry.depth >= 0);
+    const auto i = index(entry.hash);
+    std::scoped_lock lock(lockFor(i));
+    auto& slot = entries[i];
+    if (slot.hash != entry.hash || slot.depth <= entry.depth)
+      slot = std::move(entry);
+  }
+
+  void TranspositionTable::clear()
+  {
+    for (std::size_t i = 0; i < entries.size(); ++i)
+    {
+      std::scoped_lock lock(lockFor(i));
+      entries[i] = Entry{};
+    }
+  }
+} // namespace solver
@@ -1,10 +1,22 @@
+#include "solver/TreeSearch.hpp"
+
+#include "solver/Bounds.hpp"
+#include "solver/DominanceStore.hpp"
 #include "solver/Fitness.hpp"
+#include "solver/PackedStep.hpp"
 #include "solver/Solver.hpp"
+#include "solver/SolverControl.hpp"
 #include "solver/SolverTools.hpp"
+#include "solver/StateHash.hpp"
+#include "solver/TranspositionTable.hpp"
 
 #include <algorithm>
+#include <atomic>
 #include <execution>
-#include <iostream>
+#include <limits>
+#include <optional>
+#include <span>
+#include <string>
 
 namespace
 {
@@ -112,35 +124,198 @@ namespace
                    [&](Cast cast) { return rateSpell(state, cast.spell); }, [](Uncover) { return 1; },
                    [](Buy) { return 1; }, [](Use) { return 3; }, [](Convert) { return 0; }, [](Find) { return 20; },
                    [](FindFree) { return 21; }, [](Follow) { return 8; }, [](Request) { return 4; },
-                   [](Desecrate) { return -2; }, [](ChangeTarget) { return 1; }, [](NoOp) { return 0; }},
+                   [](Desecrate) { return -2; }, [](ChangeTarget) { return 1; }, [](NoOp) { return 0; },
+                   [&](Fight) { return rateStep(state, Attack{}); }},
         step);
   }
 
-  using RatedSolution = std::pair<Solution, int>;
+  struct RatedSolution
+  {
+    PackedSolution solution;
+    int score;
+    // Every line was searched to a win or a defeat, so the score is not an estimate
+    bool proven{false};
+    // Some line was cut short (pruned, dominated or aborted), so the score may be too low for other searches
+    bool inexact{false};
+  };
+
+  // Proven results hold for any depth and are stored in the transposition table as such
+  constexpr int ProvenDepth = std::numeric_limits<int>::max();
+
+  // Result for a state that was not searched because it is not expected to improve on the best line, never preferred
+  const RatedSolution pruned{{}, std::numeric_limits<int>::min(), false, true};
+  using Clock = std::chrono::steady_clock;
+
+  // Ends an iteration of the search once the solver is stopped or the time for the current step is up.  Stays
+  // triggered, so that the caller can tell whether the iteration was completed.
+  class Cutoff
+  {
+  public:
+    Cutoff(const SolverControl& control, std::optional<Clock::time_point> deadline)
+      : control(control)
+      , deadline(deadline)
+    {
+    }
+
+    bool operator()() const
+    {
+      if (!triggered && (control.shouldStop() || (deadline && Clock::now() >= *deadline)))
+        triggered = true;
+      return triggered;
+    }
+
+  private:
+    const SolverControl& control;
+    std::optional<Clock::time_point> deadline;
+    mutable std::atomic<bool> triggered{false};
+  };
+
+  // Best score reached by any line of the current iteration, shared by all threads of the search
+  class SharedBound
+  {
+  public:
+    explicit SharedBound(int initial)
+      : best(initial)
+    {
+    }
+
+    int get() const { return best.load(std::memory_order_relaxed); }
+
+    void raise(int score)
+    {
+      auto current = get();
+      while (score > current && !best.compare_exchange_weak(current, score, std::memory_order_relaxed))
+      {
+      }
+    }
+
+  private:
+    std::atomic<int> best;
+  };
 
-  // Finds best solution within the maximum allowed depth. Solution is in reverse order.
-  RatedSolution search(const GameState& state, const StateFitnessRating& fitnessRating, int maxDepth, bool run_parallel)
+  // State of one iteration of the search, shared by all of its threads
+  struct SearchContext
   {
+    const StateFitnessRating& fitnessRating;
+    const Cutoff& cutoff;
+    SharedBound& bound;
+    solver::TranspositionTable& table;
+    solver::DominanceStore& dominance;
+    SolverControl& control;
+    // Found once for the root of the search (@see solver::helpfulItems); empty unless the heuristic cut is enabled
+    std::span<const Item> helpfulItems;
+    bool heuristicCut;
+    // Nodes with at least this remaining depth search their younger children in parallel
+    int minSplitDepth;
+
+    // Once any line wins, nothing can improve on it and all other threads give up
+    bool aborted() const { return bound.get() == fitnessRating.GAME_WON || cutoff(); }
+
+    // Heuristic cut, if enabled (@see TreeSearchSettings::heuristicCut): a state is not expected to improve on the
+    // best line if even its estimated bounds do not exceed it.  The estimates are not admissible, so this may cut a
+    // better line.  Only pays off if the state would be expanded.
+    bool canPrune(const GameState& state, int maxDepth) const
+    {
+      if (!heuristicCut || maxDepth == 0 || state.hero.isDefeated() || state.visibleMonsters.empty())
+        return false;
+      return solver::HeuristicBounds{state, helpfulItems}.within(static_cast<unsigned>(maxDepth)) <= bound.get();
+    }
+  };
+
+  // How a node of the search distributes its children over threads
+  enum class Split
+  {
+    None,
+    // All children concurrently (root of a parallel search)
+    All,
+    // Eldest child first, then the younger ones concurrently
+    YoungBrothers,
+  };
+
+  RatedSolution
+  search(GameState& state, int maxDepth, Split split, std::span<const PackedStep> pv, SearchContext& context);
+
+  // Search the children for `steps` concurrently, each on a copy of `state`
+  std::vector<RatedSolution> searchParallel(const GameState& state,
+                                            std::span<const Step> steps,
+                                            int maxDepth,
+                                            std::span<const PackedStep> pv,
+                                            SearchContext& context)
+  {
+    context.control.add({.statesApplied = steps.size()});
+    auto ratedSolutions = std::vector<RatedSolution>(steps.size());
+    std::transform(std::execution::par, begin(steps), end(steps), begin(ratedSolutions), [&](const Step& step) {
+      auto childState = solver::apply(step, state);
+      if (context.canPrune(childState, maxDepth - 1))
+        return pruned;
+      const auto childPv = !pv.empty() && pv.front() == PackedStep{step} ? pv.subspan(1) : pv.first(0);
+      auto ratedSolution = search(childState, maxDepth - 1, Split::YoungBrothers, childPv, context);
+      ratedSolution.solution.emplace_back(step);
+      return ratedSolution;
+    });
+    return ratedSolutions;
+  }
+
+  // Finds best solution within the maximum allowed depth. Solution is in reverse order and packed, to keep the
+  // partial solutions passed up the recursion small.
+  // States found in the transposition table are not expanded again; only their best first step is returned.
+  // Child states are visited by applying steps in place and reverting them; `state` is unchanged on return.
+  // The first step of the principal variation `pv` (in order) is tried first, and its tail is passed on to that child.
+  // In parallel mode, all steps of the root are searched concurrently.  Below the root, nodes with enough remaining
+  // depth search their eldest child first and the younger ones concurrently ("young brothers wait"); the nested
+  // parallel algorithms are balanced by the work-stealing scheduler of the thread pool.
+  // States dominated by a state searched before are pruned (@see solver::DominanceStore), and so are children not
+  // expected to improve on the best line if the heuristic cut is enabled (@see SearchContext::canPrune).  Results
+  // that depend on such cuts are marked inexact and kept out of the transposition table.
+  // If the search is aborted (@see SearchContext::aborted), its result must be discarded unless it is a win.
+  RatedSolution
+  search(GameState& state, int maxDepth, Split split, std::span<const PackedStep> pv, SearchContext& context)
+  {
+    const auto& fitnessRating = context.fitnessRating;
+    auto& control = context.control;
+    control.addNodes(1);
     if (state.hero.isDefeated())
-      return {{}, fitnessRating.GAME_LOST};
+      return {{}, fitnessRating.GAME_LOST, true};
     if (state.visibleMonsters.empty())
-      return {{}, fitnessRating.GAME_WON};
+    {
+      context.bound.raise(fitnessRating.GAME_WON);
+      return {{}, fitnessRating.GAME_WON, true};
+    }
     if (maxDepth == 0)
-      return {{}, fitnessRating(state)};
+    {
+      const auto score = fitnessRating(state);
+      context.bound.raise(score);
+      return {{}, score};
+    }
     const auto steps = solver::generateAllValidSteps(state, false);
-    if (run_parallel)
+    if (split == Split::All)
     {
-      auto ratedSolutions = std::vector<RatedSolution>(steps.size());
-      std::transform(std::execution::par_unseq, begin(steps), end(steps), begin(ratedSolutions), [&](Step step) {
-        auto [solution, score] = search(solver::apply(step, std::move(state)), fitnessRating, maxDepth - 1, false);
-        solution.push_back(step);
-        return std::pair{std::move(solution), score};
-      });
+      auto ratedSolutions = searchParallel(state, steps, maxDepth, pv, context);
+      const auto proven = std::all_of(begin(ratedSolutions), end(ratedSolutions),
+                                      [](const auto& rated) { return rated.proven; });
+      const auto inexact = std::any_of(begin(ratedSolutions), end(ratedSolutions),
+                                       [](const auto& rated) { return rated.inexact; });
+      auto best = *std::max_element(begin(ratedSolutions), end(ratedSolutions),
+                                    [](const auto& a, const auto& b) { return a.score < b.score; });
+      const auto won = best.score == fitnessRating.GAME_WON;
+      best.proven = best.proven && (proven || won);
+      best.inexact = inexact && !won;
+      return best;
+    }
 
-      auto bestIter = std::max_element(begin(ratedSolutions), end(ratedSolutions),
-                                       [](const auto& a, const auto& b) { return a.second < b.second; });
-      return *bestIter;
+    const auto stateHash = solver::hash(state);
+    if (const auto entry = context.table.lookup(stateHash, maxDepth))
+    {
+      control.add({.cacheHits = 1});
+      context.bound.raise(entry->score);
+      const auto proven = entry->depth == ProvenDepth;
+      if (entry->bestStep == PackedStep{NoOp{}})
+        return {{}, entry->score, proven};
+      return {{entry->bestStep}, entry->score, proven};
     }
+    if (context.dominance.dominatedOrInsert(stateHash ^ solver::quantityHash(state), solver::Quantities{state},
+                                            maxDepth))
+      return pruned;
 
     // Process steps in order of heuristic rating
     std::vector<std::pair<Step, int>> scoredSteps;
@@ -153,44 +328,144 @@ namespace
       // TODO: This is much too crude, and the heuristic is not yet doing a good job
       scoredSteps.resize(scoredSteps.size() * 3 / 4);
     }
+    // The truncation only depends on the state; it is part of the generation of steps, and losses are proven for the
+    // remaining ones.  The first step of the principal variation is tried first, and restored if the truncation
+    // dropped it.
+    if (!pv.empty())
+    {
+      const auto isPvStep = [&](const Step& step) { return PackedStep{step} == pv.front(); };
+      const auto pvStep = std::find_if(begin(scoredSteps), end(scoredSteps),
+                                       [&](const auto& scored) { return isPvStep(scored.first); });
+      if (pvStep != end(scoredSteps))
+        std::rotate(begin(scoredSteps), pvStep, std::next(pvStep));
+      else if (const auto dropped = std::find_if(begin(steps), end(steps), isPvStep); dropped != end(steps))
+        scoredSteps.emplace(begin(scoredSteps), *dropped, rateStep(state, *dropped));
+    }
+    // Only if all children are searched (and none pruned) can a loss be proven
+    bool proven = true;
+    bool inexact = false;
 
     int bestScore = fitnessRating.GAME_LOST;
-    Solution bestSolution;
-    for (auto& [step, _] : scoredSteps)
+    PackedSolution bestSolution;
+    const auto consider = [&](RatedSolution&& rated, const Step* step) {
+      proven = proven && rated.proven;
+      inexact = inexact || rated.inexact;
+      if (rated.score > bestScore)
+      {
+        bestScore = rated.score;
+        bestSolution = std::move(rated.solution);
+        if (step)
+          bestSolution.emplace_back(*step);
+      }
+    };
+    const auto childPv = [pv](const Step& step) {
+      return !pv.empty() && pv.front() == PackedStep{step} ? pv.subspan(1) : pv.first(0);
+    };
+    const auto childSplit = split == Split::None ? Split::None : Split::YoungBrothers;
+    SolverCounts counts{.cacheMisses = 1};
+    for (std::size_t i = 0; i < scoredSteps.size(); ++i)
     {
-      auto updated = solver::apply(step, state);
-      auto [solution, score] = search(updated, fitnessRating, maxDepth - 1, false);
-      if (score > bestScore)
+      if (i == 1 && split == Split::YoungBrothers && maxDepth >= context.minSplitDepth && scoredSteps.size() > 2)
       {
-        bestScore = score;
-        bestSolution = std::move(solution);
-        bestSolution.push_back(std::move(step));
+        // The eldest brother has been searched; its younger brothers are searched concurrently
+        std::vector<Step> youngerSteps;
+        for (auto scored = std::next(begin(scoredSteps)); scored != end(scoredSteps); ++scored)
+          youngerSteps.push_back(scored->first);
+        for (auto& rated : searchParallel(state, youngerSteps, maxDepth, pv, context))
+          consider(std::move(rated), nullptr);
+        if (bestScore != fitnessRating.GAME_WON && context.aborted())
+        {
+          control.add(counts);
+          return {std::move(bestSolution), bestScore, false, true};
+        }
+        break;
       }
-      if (score == fitnessRating.GAME_WON)
+      const auto& step = scoredSteps[i].first;
+      ++counts.statesApplied;
+      auto undo = solver::applyInPlace(step, state);
+      auto rated = context.canPrune(state, maxDepth - 1)
+                       ? pruned
+                       : search(state, maxDepth - 1, childSplit, childPv(step), context);
+      solver::unapply(step, std::move(undo), state);
+      const auto won = rated.score == fitnessRating.GAME_WON;
+      consider(std::move(rated), &step);
+      if (won)
         break;
+      if (context.aborted())
+      {
+        control.add(counts);
+        return {std::move(bestSolution), bestScore, false, true};
+      }
     }
-    return {std::move(bestSolution), bestScore};
+    control.add(counts);
+    if (bestScore == fitnessRating.GAME_WON)
+    {
+      proven = true;
+      inexact = false;
+    }
+    // An inexact score may be too low for other searches reaching this state
+    if (!inexact)
+      context.table.store({stateHash, bestScore, proven ? ProvenDepth : maxDepth,
+                           bestSolution.empty() ? PackedStep{NoOp{}} : bestSolution.back()});
+    return {std::move(bestSolution), bestScore, proven, inexact};
   }
 } // namespace
 
-std::optional<Solution> runTreeSearch(GameState state)
+std::optional<Solution> runTreeSearch(GameState state, SolverControl& control, const TreeSearchSettings& settings)
 {
+  state.hero.add(HeroStatus::Pessimist);
   Solution solution{};
   auto fitness = StateFitnessRating1{};
+  auto table = solver::TranspositionTable{};
+  auto dominance = solver::DominanceStore{};
+  const auto split = control.getNumThreads() != 1 ? Split::All : Split::None;
   while (!state.visibleMonsters.empty())
   {
-    auto [partialSolution, score] = search(state, fitness, 6, true);
-    if (score == fitness.GAME_LOST)
-      return std::nullopt;
-    // partial solutions are returned in reverse order
-    std::reverse(begin(partialSolution), end(partialSolution));
-    std::cout << "------------------------------------------" << std::endl;
-    solver::print(partialSolution, state);
-    std::cout << "SCORE SO FAR: " << score << std::endl;
-    std::cout << "------------------------------------------" << std::endl;
+    // Principal variation (in order) and score of the deepest completed iteration
+    PackedSolution principalVariation;
+    int score = fitness.GAME_LOST;
+    int depth = 0;
+    const auto deadline = Clock::now() + settings.timePerStep;
+    const auto helpfulItems = settings.heuristicCut ? solver::helpfulItems(state) : std::vector<Item>{};
+    while (depth < settings.maxDepth)
+    {
+      // The first iteration is only aborted if the solver is stopped, so that there is always a step to commit
+      const Cutoff cutoff{control, depth > 0 ? std::optional{deadline} : std::nullopt};
+      SharedBound bound{fitness.GAME_LOST};
+      // Dominating states must have been searched in the same iteration
+      dominance.clear();
+      SearchContext context{fitness, cutoff, bound, table, dominance, control, helpfulItems, settings.heuristicCut,
+                            settings.minSplitDepth};
+      auto [packedSolution, newScore, proven, inexact] = search(state, depth + 1, split, principalVariation, context);
+      if (cutoff())
+        break;
+      // Every line was searched to the hero's defeat; no deeper iteration can change that
+      if (proven && newScore == fitness.GAME_LOST)
+        return control.shouldStop() ? std::optional{solution} : std::nullopt;
+      // partial solutions are returned in reverse order
+      std::reverse(begin(packedSolution), end(packedSolution));
+      principalVariation = std::move(packedSolution);
+      score = newScore;
+      ++depth;
+      if (score == fitness.GAME_WON)
+        break;
+    }
+    // Only a proven loss returns nullopt; otherwise the steps committed so far are the best line found
+    if (depth == 0 || score == fitness.GAME_LOST)
+      return solution;
+
+    const auto partialSolution = unpack(principalVariation);
+    control.trace([&] {
+      return TraceEvent{"partial solution", static_cast<unsigned>(solution.size()), score, toString(partialSolution),
+                        "depth " + std::to_string(depth)};
+    });
     state = solver::apply(partialSolution, std::move(state));
     std::copy(begin(partialSolution), end(partialSolution), std::back_inserter(solution));
+    control.report(static_cast<unsigned>(solution.size()), score, static_cast<unsigned>(depth));
     assert(!state.hero.isDefeated());
+    // Return the best line found so far when cancelled or out of budget
+    if (control.shouldStop())
+      return solution;
   }
   return solution;
 }
@@ -0,0 +1,177 @@
+#include "solver/ValidSteps.hpp"
+
+#include "solver/SolverTools.hpp"
+#include "solver/StateHash.hpp"
+
+#include "engine/Magic.hpp"
+#include "engine/Random.hpp"
+
+#include <algorithm>
+#include <random>
+#include <stdexcept>
+
+namespace solver
+{
+  namespace
+  {
+    // Monsters that only differ by their ID lead to equivalent states when targeted, unless the followed deity
+    // remembers something different about them
+    bool interchangeable(const Monster& a, const Monster& b, const Faith& faith)
+    {
+      return a.getName() == b.getName() && hash(a) == hash(b) &&
+             faith.getMonsterHistory(a.getID()) == faith.getMonsterHistory(b.getID());
+    }
+
+    template <class Enum>
+    constexpr std::size_t numValues(Enum last)
+    {
+      return static_cast<std::size_t>(last) + 1;
+    }
+
+    // Steps whose number is bounded by the enums alone: Attack, Fight, two Uncovers, casts, pacts, boons, and following
+    // or desecrating each god.  Items, found spells and target changes depend on the sizes of inventory, resources and
+    // monster list, which have no such bound.
+    constexpr std::size_t maxNumEnumeratedSteps = 4 + numValues(Spell::Last) + numValues(Pact::LastWithConsensus) +
+                                                  numValues(Boon::Last) + 2 * numValues(God::Last);
+  } // namespace
+
+  static_assert(ValidSteps::capacity >= 2 * maxNumEnumeratedSteps,
+                "Capacity shall leave at least as much room for items, spells and targets");
+
+  ValidSteps::ValidSteps(const GameState& state, bool allowTargetChange)
+  {
+    const auto& hero = state.hero;
+    const auto& monsters = state.visibleMonsters;
+    const bool hasMonster = state.activeMonster < monsters.size();
+    add(Attack{});
+    if (hasMonster && continuesFight(state))
+    {
+      // A fight that ends after the first attack is the same as an Attack
+      const auto& monster = monsters[state.activeMonster];
+      if (monster.getDeathProtection() > 0 ||
+          monster.predictDamageTaken(hero.getDamageOutputVersus(monster), hero.damageType()) < monster.getHitPoints())
+        add(Fight{});
+    }
+    if (state.resources.numHiddenTiles > 0)
+    {
+      add(Uncover{1});
+      const auto numTiles = std::min(state.resources.numHiddenTiles, hero.numSquaresForFullRecovery());
+      if (numTiles > 1)
+        add(Uncover{numTiles});
+    }
+    for (auto& entry : hero.getItemsAndSpells())
+    {
+      if (const auto spell = std::get_if<Spell>(&entry.itemOrSpell))
+      {
+        if ((!Magic::needsMonster(*spell) && Magic::isPossible(hero, *spell, state.resources)) ||
+            (hasMonster && Magic::isPossible(hero, monsters[state.activeMonster], *spell, state.resources)))
+          add(Cast{*spell});
+      }
+      else if (const auto item = std::get<Item>(entry.itemOrSpell); hero.canUse(item))
+        add(Use{item});
+      if (entry.conversionPoints >= 0)
+        add(Convert{entry.itemOrSpell});
+    }
+    for (const auto& item : state.resources.shops)
+    {
+      if (hero.canAfford(item) && hero.hasRoomFor(item))
+        add(Buy{item});
+    }
+    if (hero.hasRoomFor(Spell::Burndayraz))
+    {
+      for (const auto& spell : state.resources.spells)
+        add(Find{spell});
+      for (const auto& spell : state.resources.freeSpells)
+        add(FindFree{spell});
+    }
+    const auto& faith = hero.getFaith();
+    if (state.resources.pactmakerAvailable() && !faith.getPact())
+    {
+      for (int i = 0; i < static_cast<int>(Pact::LastNoConsensus); ++i)
+        add(Request{static_cast<Pact>(i)});
+      if (!faith.enteredConsensus())
+        add(Request{Pact::Consensus});
+    }
+    if (state.hero.getFollowedDeity())
+    {
+      for (const auto boon : offeredBoons(*state.hero.getFollowedDeity()))
+      {
+        const auto costs = hero.getBoonCosts(boon);
+        if ((costs <= 0 || hero.getPiety() >= static_cast<unsigned>(costs)) &&
+            faith.isAvailable(boon, hero, monsters, state.resources))
+          add(Request{boon});
+      }
+      const bool canConvert = faith.getPiety() >= 50;
+      const bool canDesecrate = !hero.has(HeroTrait::Scapegoat);
+      if (canConvert || canDesecrate)
+      {
+        for (const auto& altar : state.resources.altars)
+        {
+          if (const auto god = std::get_if<God>(&altar); god && *god != state.hero.getFollowedDeity())
+          {
+            if (canConvert)
+              add(Follow{*god});
+            if (canDesecrate)
+              add(Desecrate{*god});
+          }
+        }
+      }
+    }
+    else
+    {
+      for (const auto& altar : state.resources.altars)
+      {
+        if (const auto god = std::get_if<God>(&altar))
+          add(Follow{*god});
+      }
+    }
+    if (allowTargetChange)
+    {
+      // Only the first monster of each kind of interchangeable monsters is offered as a target
+      for (auto monsterIndex = 0u; monsterIndex < monsters.size(); ++monsterIndex)
+      {
+        const auto& monster = monsters[monsterIndex];
+        const auto isRepeated = [&](std::size_t otherIndex) {
+          return otherIndex < monsters.size() && interchangeable(monsters[otherIndex], monster, faith);
+        };
+        bool repeated = isRepeated(state.activeMonster);
+        for (auto otherIndex = 0u; otherIndex < monsterIndex && !repeated; ++otherIndex)
+          repeated = isRepeated(otherIndex);
+        if (monsterIndex != state.activeMonster && !repeated)
+          add(ChangeTarget{monsterIndex});
+      }
+    }
+  }
+
+  void ValidSteps::add(const Step& step)
+  {
+    // Dropping a step would silently bias random draws and invalidate exhaustive searches
+    if (numSteps == capacity)
+      throw std::length_error("Too many valid steps");
+    const auto request = std::get_if<Request>(&step);
+    const auto type = request && std::holds_alternative<Pact>(request->boonOrPact) ? numTypes - 1 : step.index();
+    steps[numSteps] = step;
+    types[numSteps] = static_cast<std::uint8_t>(type);
+    ++typeCounts[type];
+    ++numSteps;
+  }
+
+  Step ValidSteps::random() const
+  {
+    if (empty())
+      return NoOp{};
+    std::size_t numNonEmptyTypes = 0;
+    for (const auto count : typeCounts)
+      numNonEmptyTypes += count > 0 ? 1 : 0;
+    auto typeIndex = std::uniform_int_distribution<std::size_t>(0, numNonEmptyTypes - 1)(randomGenerator());
+    std::size_t type = 0;
+    while (typeCounts[type] == 0 || typeIndex-- > 0)
+      ++type;
+    auto stepIndex = std::uniform_int_distribution<std::size_t>(0, typeCounts[type] - 1u)(randomGenerator());
+    for (std::size_t i = 0;; ++i)
+    {
+      if (types[i] == type && stepIndex-- == 0)
+        return steps[i].unpack();
+    }
+  }
+} // namespace solver
@@ -0,0 +1,115 @@
+#include "engine/Combat.hpp"
+#include "engine/Magic.hpp"
+#include "solver/Benchmark.hpp"
+#include "solver/Fitness.hpp"
+#include "solver/GameState.hpp"
+#include "solver/Scenario.hpp"
+#include "solver/SolverTools.hpp"
+
+#include <functional>
+#include <optional>
+
+using namespace benchmark;
+
+namespace
+{
+  // Initial states of all scenarios; monsters are generated randomly, so the generator is seeded first
+  std::vector<GameState> scenarioStates()
+  {
+    seedRandomGenerator(42);
+    std::vector<GameState> states;
+    for (int i = 0; i <= static_cast<int>(Scenario::Last); ++i)
+    {
+      states.push_back(initialState(static_cast<Scenario>(i)));
+    }
+    return states;
+  }
+
+  // First spell that the hero of a scenario can cast on the active monster, if any
+  std::optional<Spell> castableSpell(const GameState& state)
+  {
+    for (const auto& step : solver::generateAllValidSteps(state, false))
+    {
+      if (const auto cast = std::get_if<Cast>(&step))
+        return cast->spell;
+    }
+    return std::nullopt;
+  }
+
+  std::vector<Benchmark> benchmarks()
+  {
+    static const auto states = scenarioStates();
+    const auto numStates = states.size();
+    // Read-only access to the scenario states, cycling through all of them
+    const auto shared = [&, numStates](std::size_t index) { return std::cref(states[index % numStates]); };
+    // Individual copies of the scenario states, for operations that modify them
+    const auto copy = [&, numStates](std::size_t index) { return states[index % numStates]; };
+
+    return {
+        {"Hero copy", [=] { return measure(shared, [](const GameState& state) { keep(Hero{state.hero}); }); }},
+        {"GameState copy", [=] { return measure(shared, [](const GameState& state) { keep(GameState{state}); }); }},
+        {"Combat::attack", [=] {
+           return measure(copy, [](GameState& state) {
+             auto& monsters = state.visibleMonsters;
+             keep(Combat::attack(state.hero, monsters[state.activeMonster], monsters, state.resources));
+           });
+         }},
+        {"Magic::cast", [=] {
+           struct Fixture
+           {
+             GameState state;
+             Spell spell;
+           };
+           std::vector<Fixture> fixtures;
+           for (const auto& state : states)
+           {
+             if (const auto spell = castableSpell(state))
+               fixtures.push_back({state, *spell});
+           }
+           return measure([fixtures](std::size_t index) { return fixtures[index % fixtures.size()]; },
+                          [](Fixture& fixture) {
+                            auto& [state, spell] = fixture;
+                            auto& monsters = state.visibleMonsters;
+                            keep(Magic::cast(state.hero, monsters[state.activeMonster], spell, monsters,
+                                             state.resources));
+                          });
+         }},
+        {"Hero::recover", [=] {
+           return measure(copy, [](GameState& state) {
+             state.hero.recover(1, state.visibleMonsters);
+             keep(state.hero);
+           });
+         }},
+        {"solver::apply", [=] {
+           // Random valid steps are drawn during setup, the state is moved into apply so that it is not copied
+           const auto setup = [=](std::size_t index) {
+             auto state = copy(index);
+             auto step = solver::generateRandomValidStep(state, false);
+             return std::pair{std::move(step), std::move(state)};
+           };
+           return measure(setup, [](std::pair<Step, GameState>& fixture) {
+             keep(solver::apply(fixture.first, std::move(fixture.second)));
+           });
+         }},
+        {"solver::generateAllValidSteps", [=] {
+           return measure(shared,
+                          [](const GameState& state) { keep(solver::generateAllValidSteps(state, true)); });
+         }},
+        {"solver::generateRandomValidStep", [=] {
+           return measure(shared,
+                          [](const GameState& state) { keep(solver::generateRandomValidStep(state, false)); });
+         }},
+        {"StateFitnessRating1", [=] {
+           return measure(shared, [rating = StateFitnessRating1{}](const GameState& state) { keep(rating(state)); });
+         }},
+        {"StateFitnessRating2", [=] {
+           return measure(shared, [rating = StateFitnessRating2{}](const GameState& state) { keep(rating(state)); });
+         }},
+    };
+  }
+} // namespace
+
+int main(int argc, char* argv[])
+{
+  return benchmark::main(argc, argv, benchmarks());
+}
@@ -0,0 +1,203 @@
+#include "solver/GameState.hpp"
+#include "solver/Scenario.hpp"
+#include "solver/Solver.hpp"
+#include "solver/SolverControl.hpp"
+#include "solver/SolverTools.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#ifndef _WIN32
+#include <tbb/global_control.h>
+#endif
+
+namespace
+{
+  using Clock = std::chrono::steady_clock;
+
+  struct Settings
+  {
+    std::vector<Solver> solvers;
+    std::vector<Scenario> scenarios;
+    unsigned repetitions{3};
+    unsigned numThreads{0};
+    std::chrono::milliseconds timeBudget{std::chrono::seconds{60}};
+    std::uint64_t seed{42};
+  };
+
+  struct Run
+  {
+    bool solved{false};
+    double seconds{0};
+    std::uint64_t numNodes{0};
+  };
+
+  GameState initialState(Scenario scenario, std::uint64_t seed)
+  {
+    // Monsters are generated randomly, so every repetition starts from the same state
+    seedRandomGenerator(seed);
+    return ::initialState(scenario);
+  }
+
+  // A solution succeeds if it defeats all visible monsters, assuming the worst for all random events
+  bool isWinning(const Solution& solution, GameState state)
+  {
+    state.hero.add(HeroStatus::Pessimist);
+    state = solver::apply(solution, std::move(state));
+    return !state.hero.isDefeated() && state.visibleMonsters.empty();
+  }
+
+  Run runOnce(Solver solver, Scenario scenario, std::uint64_t seed, const Settings& settings)
+  {
+    auto state = initialState(scenario, seed);
+    auto control =
+        SolverControl{{.timeBudget = settings.timeBudget, .numThreads = settings.numThreads, .seed = seed}};
+
+    const auto start = Clock::now();
+    const auto solution = run(solver, state, control);
+    const auto elapsed = Clock::now() - start;
+
+    return {solution && isWinning(*solution, std::move(state)), std::chrono::duration<double>(elapsed).count(),
+            control.getNumNodes()};
+  }
+
+  void printHeader()
+  {
+    std::cout << std::left << std::setw(26) << "Solver" << std::setw(36) << "Scenario" << std::right << std::setw(9)
+              << "success" << std::setw(14) << "median t [s]" << std::setw(14) << "mean nodes" << std::setw(14)
+              << "states/s" << std::endl;
+  }
+
+  // Time to solution is the median over successful runs; nodes and throughput include failed runs
+  void printRow(Solver solver, Scenario scenario, std::vector<Run> runs)
+  {
+    std::vector<double> solvedSeconds;
+    double totalSeconds = 0;
+    std::uint64_t totalNodes = 0;
+    for (const auto& run : runs)
+    {
+      if (run.solved)
+        solvedSeconds.push_back(run.seconds);
+      totalSeconds += run.seconds;
+      totalNodes += run.numNodes;
+    }
+    std::ostringstream success;
+    success << solvedSeconds.size() << "/" << runs.size();
+    std::ostringstream median;
+    if (solvedSeconds.empty())
+      median << "-";
+    else
+    {
+      std::nth_element(begin(solvedSeconds), begin(solvedSeconds) + solvedSeconds.size() / 2, end(solvedSeconds));
+      median << std::fixed << std::setprecision(2) << solvedSeconds[solvedSeconds.size() / 2];
+    }
+    std::cout << std::left << std::setw(26) << toString(solver) << std::setw(36) << toString(scenario) << std::right
+              << std::setw(9) << success.str() << std::setw(14) << median.str() << std::fixed << std::setprecision(0)
+              << std::setw(14) << static_cast<double>(totalNodes) / static_cast<double>(runs.size()) << std::setw(14)
+              << (totalSeconds > 0 ? static_cast<double>(totalNodes) / totalSeconds : 0) << std::endl;
+  }
+
+  template <class Enum>
+  std::optional<Enum> parse(const std::string& name, Enum last)
+  {
+    for (int i = 0; i <= static_cast<int>(last); ++i)
+    {
+      const auto value = static_cast<Enum>(i);
+      if (std::string{toString(value)}.find(name) != std::string::npos)
+        return value;
+    }
+    return std::nullopt;
+  }
+
+  std::optional<Settings> parseArguments(int argc, char* argv[])
+  {
+    Settings settings;
+    for (int i = 1; i + 1 < argc; i += 2)
+    {
+      const std::string option = argv[i];
+      const std::string value = argv[i + 1];
+      if (option == "--solver")
+      {
+        const auto solver = parse(value, Solver::Last);
+        if (!solver)
+          return std::nullopt;
+        settings.solvers.push_back(*solver);
+      }
+      else if (option == "--scenario")
+      {
+        const auto scenario = parse(value, Scenario::Last);
+        if (!scenario)
+          return std::nullopt;
+        settings.scenarios.push_back(*scenario);
+      }
+      else if (option == "--repetitions")
+        settings.repetitions = std::max(static_cast<unsigned>(std::stoul(value)), 1u);
+      else if (option == "--threads")
+        settings.numThreads = static_cast<unsigned>(std::stoul(value));
+      else if (option == "--time-budget")
+        settings.timeBudget = std::chrono::milliseconds{static_cast<long>(std::stod(value) * 1000)};
+      else if (option == "--seed")
+        settings.seed = std::stoull(value);
+      else
+        return std::nullopt;
+    }
+    if (argc % 2 == 0)
+      return std::nullopt;
+    if (settings.solvers.empty())
+    {
+      for (int i = 0; i <= static_cast<int>(Solver::Last); ++i)
+        settings.solvers.push_back(static_cast<Solver>(i));
+    }
+    if (settings.scenarios.empty())
+    {
+      for (int i = 0; i <= static_cast<int>(Scenario::Last); ++i)
+        settings.scenarios.push_back(static_cast<Scenario>(i));
+    }
+    return settings;
+  }
+} // namespace
+
+/** Runs every solver against every built-in scenario and reports success rate, median time to solution, evaluated
+ *  nodes and throughput.  Repetition r of a scenario uses seed + r, both for generating the scenario's monsters and
+ *  for the solver, so that runs are comparable between builds.
+ **/
+int main(int argc, char* argv[])
+{
+  const auto settings = parseArguments(argc, argv);
+  if (!settings)
+  {
+    std::cerr << "Usage: " << argv[0]
+              << " [--solver <name>]... [--scenario <name>]... [--repetitions <n>] [--threads <n>]"
+                 " [--time-budget <seconds>] [--seed <n>]"
+              << std::endl;
+    return 1;
+  }
+
+#ifndef _WIN32
+  std::unique_ptr<tbb::global_control> threadLimit;
+  if (settings->numThreads > 0)
+    threadLimit = std::make_unique<tbb::global_control>(tbb::global_control::max_allowed_parallelism,
+                                                        settings->numThreads);
+#endif
+
+  printHeader();
+  for (const auto solver : settings->solvers)
+  {
+    for (const auto scenario : settings->scenarios)
+    {
+      std::vector<Run> runs;
+      for (unsigned rep = 0; rep < settings->repetitions; ++rep)
+        runs.push_back(runOnce(solver, scenario, settings->seed + rep, *settings));
+      printRow(solver, scenario, std::move(runs));
+    }
+  }
+  return 0;
+}
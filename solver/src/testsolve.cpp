@@ -1,14 +1,36 @@
 #include "bandit/bandit.h"
 
+#include "solver/Bounds.hpp"
+#include "solver/DominanceStore.hpp"
+#include "solver/FightCache.hpp"
+#include "solver/Fitness.hpp"
 #include "solver/GameState.hpp"
+#include "solver/GeneticAlgorithm.hpp"
 #include "solver/Heuristics.hpp"
+#include "solver/MonteCarloTreeSearch.hpp"
+#include "solver/PackedStep.hpp"
 #include "solver/Scenario.hpp"
 #include "solver/Solution.hpp"
 #include "solver/Solver.hpp"
+#include "solver/SolverJob.hpp"
 #include "solver/SolverTools.hpp"
+#include "solver/SolverTrace.hpp"
+#include "solver/StateHash.hpp"
+#include "solver/TranspositionTable.hpp"
+#include "solver/TreeSearch.hpp"
+#include "solver/ValidSteps.hpp"
 
+#include "engine/Combat.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <iostream>
 #include <iterator>
+#include <memory>
+#include <set>
+#include <stdexcept>
+#include <thread>
 
 using namespace bandit;
 using namespace snowhouse;
@@ -89,8 +111,7 @@ namespace snowhouse
 void testGeneticSolver()
 {
   const auto scenario = Scenario::HalflingTrial;
-  GameState state{
-      getHeroForScenario(scenario), getMonstersForScenario(scenario), {}, 0, getResourcesForScenario(scenario)};
+  auto state = initialState(scenario);
 
   auto solution = run(Solver::GeneticAlgorithm, state);
   if (solution)
@@ -183,6 +204,52 @@ void testHeuristics()
       assassin.loseHitPointsOutsideOfFight(assassin.getHitPoints() - 1, noOtherMonsters);
       AssertThat(heuristics::checkMeleeOnly(assassin, {MonsterType::MeatMan, Level{2}}), IsTrue());
     });
+    it("shall predict melee fights in closed form", [] {
+      Hero hero{HeroClass::Guard};
+      hero.add(HeroStatus::DeathProtection);
+      Monster monster{MonsterStats{Level{1}, 20_HP, 2_damage, DeathProtection{1}}};
+      const auto heroDamage = monster.predictDamageTaken(hero.getDamageOutputVersus(monster), hero.damageType());
+      AssertThat(heroDamage, Equals(5u));
+      const auto result = predictMelee(hero, monster);
+      AssertThat(result.heroWins, IsTrue());
+      AssertThat(result.numAttacks, Equals(5u));
+      AssertThat(result.numHitsTaken, Equals(5u));
+      AssertThat(hero.getHitPoints(), Equals(10u));
+      AssertThat(result.heroHitPoints, Equals(1u));
+      AssertThat(result.heroDeathProtectionUsed, IsTrue());
+      AssertThat(result.monsterDeathProtectionUsed, Equals(1u));
+      hero.reset(HeroStatus::DeathProtection);
+      AssertThat(predictMelee(hero, monster).heroWins, IsFalse());
+    });
+    it("shall predict melee fights like a simulation", [] {
+      for (int i = 0; i <= static_cast<int>(Scenario::Last); ++i)
+      {
+        const auto scenario = static_cast<Scenario>(i);
+        for (auto hero : {getHeroForScenario(scenario), Hero{HeroClass::Fighter}, Hero{HeroClass::Rogue}})
+        {
+          hero.add(HeroStatus::Pessimist);
+          for (const auto& monster : getMonstersForScenario(scenario))
+          {
+            const auto predicted = predictMelee(hero, monster);
+            SimpleResources resources;
+            auto simulatedHero = hero;
+            auto simulatedMonster = monster;
+            unsigned numAttacks = 0;
+            while (!simulatedHero.isDefeated() && !simulatedMonster.isDefeated() && numAttacks < 200)
+            {
+              Combat::attack(simulatedHero, simulatedMonster, noOtherMonsters, resources);
+              ++numAttacks;
+            }
+            if (numAttacks == 200)
+              numAttacks = 0;
+            AssertThat(predicted.heroWins, Equals(simulatedMonster.isDefeated()));
+            AssertThat(predicted.numAttacks, Equals(numAttacks));
+            AssertThat(predicted.monsterHitPoints, Equals(simulatedMonster.getHitPoints()));
+            AssertThat(predicted.heroHitPoints, Equals(simulatedHero.getHitPoints()));
+          }
+        }
+      }
+    });
   });
   describe("Regen fight prediction", [] {
     it("shall be correct for simple cases (1)", [] {
@@ -328,10 +395,591 @@ void testHeuristics()
       AssertThat(toRegenFightResult(solution), Equals(RegenFightResult{.numAttacks = 3u, .numSquares = 1u}));
     });
   });
+  describe("Fight cache", [] {
+    Hero hero{HeroClass::Fighter};
+    hero.add(HeroStatus::Might);
+    const Monster monster{MonsterType::Goblin, Level{1}};
+
+    it("shall store simulated fights only", [&] {
+      solver::FightCache cache;
+      AssertThat(heuristics::isStationaryFight(hero, monster), IsFalse());
+      const auto predicted = predictMelee(hero, monster);
+      for (int i = 0; i < 3; ++i)
+      {
+        const auto cached = cache.predictMelee(hero, monster);
+        AssertThat(cached.heroWins, Equals(predicted.heroWins));
+        AssertThat(cached.numAttacks, Equals(predicted.numAttacks));
+        AssertThat(cached.heroHitPoints, Equals(predicted.heroHitPoints));
+      }
+      AssertThat(cache.getNumHits(), Equals(2u));
+      const Hero plainHero{HeroClass::Fighter};
+      AssertThat(heuristics::isStationaryFight(plainHero, monster), IsTrue());
+      cache.predictMelee(plainHero, monster);
+      cache.predictMelee(plainHero, monster);
+      AssertThat(cache.getNumHits(), Equals(2u));
+    });
+    it("shall distinguish monsters by their trait parameters", [&] {
+      solver::FightCache cache;
+      const MonsterStats stats{Level{1}, 20_HP, 3_damage};
+      const Monster plain{stats};
+      const Monster berserk{stats, {}, MonsterTraits{MonsterType::Berserker}};
+      AssertThat(solver::hash(plain), Equals(solver::hash(berserk)));
+      AssertThat(predictMelee(hero, berserk).heroWins == predictMelee(hero, plain).heroWins, IsFalse());
+      cache.predictMelee(hero, plain);
+      AssertThat(cache.predictMelee(hero, berserk).heroWins, Equals(predictMelee(hero, berserk).heroWins));
+      AssertThat(cache.getNumHits(), Equals(0u));
+    });
+    it("shall distinguish heroes by their traits", [&] {
+      solver::FightCache cache;
+      auto bloodlust = hero;
+      bloodlust.add(HeroTrait::Bloodlust);
+      AssertThat(solver::hash(bloodlust), Equals(solver::hash(hero)));
+      const Monster stronger{MonsterType::Goblin, Level{3}};
+      cache.predictMelee(hero, stronger);
+      cache.predictMelee(bloodlust, stronger);
+      AssertThat(cache.getNumHits(), Equals(0u));
+    });
+    it("shall be safe to use from several threads", [&] {
+      solver::FightCache cache{16};
+      std::vector<Monster> monsters;
+      for (unsigned level = 1; level <= 10; ++level)
+        monsters.emplace_back(MonsterType::Goblin, Level{level});
+      std::atomic<int> numMismatches{0};
+      {
+        std::vector<std::jthread> threads;
+        for (int t = 0; t < 4; ++t)
+        {
+          threads.emplace_back([&] {
+            for (int i = 0; i < 100; ++i)
+            {
+              for (const auto& monster : monsters)
+              {
+                if (cache.predictMelee(hero, monster).numAttacks != predictMelee(hero, monster).numAttacks)
+                  ++numMismatches;
+              }
+            }
+          });
+        }
+      }
+      AssertThat(numMismatches.load(), Equals(0));
+      AssertThat(cache.getNumHits(), IsGreaterThan(0u));
+    });
+  });
+}
+
+void testStateHash()
+{
+  describe("State hash", [] {
+    GameState state{Hero{}, {}, {}, 0, SimpleResources{}};
+    state.visibleMonsters.emplace_back(MonsterType::Goblin, Level{1});
+    state.resources.spells = {Spell::Burndayraz, Spell::Bysseps};
+
+    it("shall not depend on the order in which a state was reached", [&] {
+      const auto stateA = solver::apply(Solution{Find{Spell::Burndayraz}, Find{Spell::Bysseps}}, state);
+      const auto stateB = solver::apply(Solution{Find{Spell::Bysseps}, Find{Spell::Burndayraz}}, state);
+      AssertThat(solver::hash(stateA), Equals(solver::hash(stateB)));
+      AssertThat(solver::hash(stateA), !Equals(solver::hash(state)));
+    });
+    it("shall reflect changes to hero and monsters", [&] {
+      const auto stateAfterAttack = solver::apply(Attack{}, state);
+      AssertThat(solver::hash(stateAfterAttack.hero), !Equals(solver::hash(state.hero)));
+      AssertThat(solver::hash(stateAfterAttack.visibleMonsters.front()),
+                 !Equals(solver::hash(state.visibleMonsters.front())));
+    });
+    it("shall reflect the piety history of visible monsters", [&] {
+      auto follower = state;
+      follower.resources.altars = {God::TikkiTooki};
+      follower = solver::apply(Follow{God::TikkiTooki}, std::move(follower));
+      auto hitByGoblin = follower;
+      (void)hitByGoblin.hero.getFaith().receivedHit(hitByGoblin.visibleMonsters.front());
+      AssertThat(hitByGoblin.hero.getFaith().getPiety(), Equals(follower.hero.getFaith().getPiety()));
+      AssertThat(solver::hash(hitByGoblin), !Equals(solver::hash(follower)));
+    });
+  });
+  describe("Applying steps in place", [] {
+    GameState state{Hero{}, {}, {}, 0, SimpleResources{}};
+    state.hero.addGold(100);
+    state.visibleMonsters.emplace_back(MonsterType::Goblin, Level{1});
+    state.visibleMonsters.emplace_back(MonsterType::MeatMan, Level{1});
+    state.resources.spells = {Spell::Burndayraz, Spell::Bysseps};
+    state.resources.shops = {Item{Potion::HealthPotion}, Item{Potion::ManaPotion}};
+
+    it("shall be reverted completely", [&] {
+      const auto initialHash = solver::hash(state);
+      const auto solution =
+          Solution{Find{Spell::Bysseps}, Buy{Potion::ManaPotion}, Attack{}, Attack{}, ChangeTarget{1}, Uncover{1}};
+      std::vector<solver::UndoRecord> undoLog;
+      for (const auto& step : solution)
+        undoLog.emplace_back(solver::applyInPlace(step, state));
+      AssertThat(state.visibleMonsters.size(), Equals(1u));
+      for (auto i = solution.size(); i-- > 0;)
+        solver::unapply(solution[i], std::move(undoLog[i]), state);
+      AssertThat(solver::hash(state), Equals(initialHash));
+      AssertThat(state.visibleMonsters.size(), Equals(2u));
+      AssertThat(state.resources.spells, Equals(std::vector{Spell::Burndayraz, Spell::Bysseps}));
+      AssertThat(state.resources.shops, Equals(std::vector<Item>{Potion::HealthPotion, Potion::ManaPotion}));
+    });
+  });
+  describe("Transposition table", [] {
+    it("shall only return entries searched to the requested depth", [] {
+      solver::TranspositionTable table{16};
+      table.store({.hash = 42u, .score = 7, .depth = 3, .bestStep = PackedStep{Attack{}}});
+      AssertThat(table.lookup(42u, 3).has_value(), IsTrue());
+      AssertThat(table.lookup(42u, 4).has_value(), IsFalse());
+      AssertThat(table.lookup(43u, 1).has_value(), IsFalse());
+      AssertThat(table.lookup(42u, 2)->score, Equals(7));
+    });
+    it("shall keep deeper results for the same state", [] {
+      solver::TranspositionTable table{16};
+      table.store({.hash = 42u, .score = 7, .depth = 3, .bestStep = PackedStep{Attack{}}});
+      table.store({.hash = 42u, .score = 5, .depth = 2, .bestStep = PackedStep{Attack{}}});
+      AssertThat(table.lookup(42u, 1)->score, Equals(7));
+      table.store({.hash = 58u, .score = 1, .depth = 1, .bestStep = PackedStep{Attack{}}});
+      AssertThat(table.lookup(42u, 1).has_value(), IsFalse());
+    });
+  });
+  describe("Dominance store", [] {
+    GameState state{Hero{HeroClass::Fighter}, {}, {}, 0, SimpleResources{}};
+    state.visibleMonsters.emplace_back(MonsterType::Goblin, Level{1});
+    it("shall identify states regardless of their quantities", [&] {
+      auto worse = state;
+      worse.hero.loseHitPointsOutsideOfFight(3, worse.visibleMonsters);
+      worse.resources.numHiddenTiles -= 1;
+      AssertThat(solver::hash(worse), !Equals(solver::hash(state)));
+      AssertThat(solver::hash(worse) ^ solver::quantityHash(worse),
+                 Equals(solver::hash(state) ^ solver::quantityHash(state)));
+      AssertThat(solver::Quantities{state}.dominates(solver::Quantities{worse}), IsTrue());
+      AssertThat(solver::Quantities{worse}.dominates(solver::Quantities{state}), IsFalse());
+      AssertThat(solver::Quantities{state}.dominates(solver::Quantities{state}), IsFalse());
+    });
+    it("shall report states dominated by one searched at least as deep", [&] {
+      auto worse = state;
+      worse.hero.loseHitPointsOutsideOfFight(3, worse.visibleMonsters);
+      solver::DominanceStore store{16};
+      AssertThat(store.dominatedOrInsert(42u, solver::Quantities{state}, 3), IsFalse());
+      AssertThat(store.dominatedOrInsert(42u, solver::Quantities{state}, 3), IsFalse());
+      AssertThat(store.dominatedOrInsert(42u, solver::Quantities{worse}, 4), IsFalse());
+      AssertThat(store.dominatedOrInsert(42u, solver::Quantities{worse}, 3), IsTrue());
+      AssertThat(store.dominatedOrInsert(43u, solver::Quantities{worse}, 1), IsFalse());
+      store.clear();
+      AssertThat(store.dominatedOrInsert(42u, solver::Quantities{worse}, 1), IsFalse());
+    });
+    it("shall not prefer more hit points for a hero who benefits from low health", [&] {
+      auto determined = state;
+      determined.hero.add(HeroTrait::Determined);
+      auto wounded = determined;
+      wounded.hero.loseHitPointsOutsideOfFight(3, wounded.visibleMonsters);
+      AssertThat(solver::Quantities{determined}.dominates(solver::Quantities{wounded}), IsFalse());
+      auto richer = determined;
+      richer.hero.addGold(5);
+      AssertThat(solver::Quantities{richer}.dominates(solver::Quantities{determined}), IsTrue());
+      solver::DominanceStore store{16};
+      AssertThat(store.dominatedOrInsert(42u, solver::Quantities{determined}, 3), IsFalse());
+      AssertThat(store.dominatedOrInsert(42u, solver::Quantities{wounded}, 3), IsFalse());
+    });
+  });
+}
+
+void testMacroSteps()
+{
+  describe("Macro steps", [] {
+    GameState state{Hero{}, {}, {}, 0, SimpleResources{}};
+    state.visibleMonsters.emplace_back(MonsterType::MeatMan, Level{1});
+    state.visibleMonsters.emplace_back(MonsterType::Goblin, Level{1});
+    state.resources.numHiddenTiles = 10;
+
+    it("shall be offered if they take several attacks or tiles", [&] {
+      auto wounded = state;
+      wounded.hero.loseHitPointsOutsideOfFight(3, wounded.visibleMonsters);
+      const solver::ValidSteps validSteps{wounded, false};
+      const auto has = [&](const Step& step) {
+        return std::find(validSteps.begin(), validSteps.end(), PackedStep{step}) != validSteps.end();
+      };
+      AssertThat(has(Fight{}), IsTrue());
+      AssertThat(has(Uncover{wounded.hero.numSquaresForFullRecovery()}), IsTrue());
+    });
+    it("shall fight until the monster is defeated", [&] {
+      const auto final = solver::apply(Solution{Fight{}}, state);
+      AssertThat(final.visibleMonsters.size(), Equals(1u));
+      AssertThat(final.hero.isDefeated(), IsFalse());
+    });
+    it("shall expand into single steps with the same outcome", [&] {
+      const auto solution = Solution{Uncover{3}, Fight{}, Fight{}};
+      const auto expanded = solver::expandMacros(solution, state);
+      const auto packed = pack(expanded);
+      AssertThat(std::count(begin(packed), end(packed), PackedStep{Uncover{1}}), Equals(3));
+      AssertThat(std::count(begin(packed), end(packed), PackedStep{Attack{}}),
+                 Equals(static_cast<std::ptrdiff_t>(packed.size()) - 3));
+      AssertThat(solver::hash(solver::apply(expanded, state)), Equals(solver::hash(solver::apply(solution, state))));
+    });
+    it("shall be reverted completely", [&] {
+      auto copy = state;
+      const auto initialHash = solver::hash(copy);
+      auto undo = solver::applyInPlace(Fight{}, copy);
+      AssertThat(copy.visibleMonsters.size(), Equals(1u));
+      solver::unapply(Fight{}, std::move(undo), copy);
+      AssertThat(solver::hash(copy), Equals(initialHash));
+    });
+  });
+}
+
+void testPackedStep()
+{
+  describe("Packed step", [] {
+    it("shall round-trip steps of every kind", [] {
+      const Solution solution{Attack{},
+                              Cast{Spell::Burndayraz},
+                              Uncover{5},
+                              Buy{Potion::ManaPotion},
+                              Use{MiscItem::PatchesTheTeddy},
+                              Convert{TaurogItem::Skullpicker},
+                              Convert{Spell::Getindare},
+                              Find{Spell::Endiswal},
+                              FindFree{Spell::Lemmisi},
+                              Follow{God::TikkiTooki},
+                              Request{Boon::Petition},
+                              Request{Pact::BodyPact},
+                              Desecrate{God::Taurog},
+                              ChangeTarget{2},
+                              NoOp{},
+                              Fight{}};
+      const auto packed = pack(solution);
+      AssertThat(packed.size(), Equals(solution.size()));
+      AssertThat(toString(unpack(packed)), Equals(toString(solution)));
+      for (std::size_t i = 0; i < packed.size(); ++i)
+      {
+        AssertThat(PackedStep{packed[i].unpack()} == packed[i], IsTrue());
+        for (std::size_t j = 0; j < i; ++j)
+          AssertThat(packed[i] == packed[j], IsFalse());
+      }
+    });
+    it("shall round-trip all valid steps of the scenarios", [] {
+      for (int i = 0; i <= static_cast<int>(Scenario::Last); ++i)
+      {
+        const auto scenario = static_cast<Scenario>(i);
+        const auto state = initialState(scenario);
+        const auto steps = solver::generateAllValidSteps(state, true);
+        AssertThat(toString(unpack(pack(steps))), Equals(toString(steps)));
+      }
+    });
+    it("shall default to attack", [] { AssertThat(PackedStep{} == PackedStep{Attack{}}, IsTrue()); });
+  });
+}
+
+void testValidSteps()
+{
+  describe("Valid steps", [] {
+    it("shall only draw valid steps of the enumerated set", [] {
+      for (int i = 0; i <= static_cast<int>(Scenario::Last); ++i)
+      {
+        const auto scenario = static_cast<Scenario>(i);
+        const auto state = initialState(scenario);
+        const solver::ValidSteps validSteps{state, false};
+        AssertThat(validSteps.empty(), IsFalse());
+        for (const auto step : validSteps)
+          AssertThat(solver::isValid(step.unpack(), state), IsTrue());
+        for (int draw = 0; draw < 100; ++draw)
+        {
+          const PackedStep step{validSteps.random()};
+          AssertThat(std::find(validSteps.begin(), validSteps.end(), step) != validSteps.end(), IsTrue());
+        }
+      }
+    });
+    it("shall draw every step type with equal probability", [] {
+      GameState state{Hero{}, {}, {}, 0, SimpleResources{}};
+      state.visibleMonsters.emplace_back(MonsterType::Goblin, Level{1});
+      state.resources.numHiddenTiles = 10;
+      state.resources.spells = {Spell::Burndayraz, Spell::Bysseps, Spell::Cydstepp, Spell::Endiswal};
+      const solver::ValidSteps validSteps{state, false};
+      std::set<std::size_t> stepTypes;
+      for (const auto step : validSteps)
+        stepTypes.insert(step.unpack().index());
+      AssertThat(validSteps.size(), IsGreaterThan(stepTypes.size() + 2));
+      const int numDraws = 3000;
+      int numAttacks = 0;
+      for (int draw = 0; draw < numDraws; ++draw)
+      {
+        if (std::holds_alternative<Attack>(validSteps.random()))
+          ++numAttacks;
+      }
+      const auto expected = numDraws / static_cast<int>(stepTypes.size());
+      AssertThat(numAttacks, IsGreaterThan(expected * 3 / 4));
+      AssertThat(numAttacks, IsLessThan(expected * 5 / 4));
+    });
+    it("shall only change targets if allowed", [] {
+      GameState state{Hero{}, {}, {}, 0, SimpleResources{}};
+      state.visibleMonsters.emplace_back(MonsterType::Goblin, Level{1});
+      state.visibleMonsters.emplace_back(MonsterType::Zombie, Level{1});
+      const auto isChangeTarget = [](PackedStep step) { return std::holds_alternative<ChangeTarget>(step.unpack()); };
+      const solver::ValidSteps withoutTargetChange{state, false};
+      AssertThat(std::none_of(withoutTargetChange.begin(), withoutTargetChange.end(), isChangeTarget), IsTrue());
+      const solver::ValidSteps withTargetChange{state, true};
+      AssertThat(std::count_if(withTargetChange.begin(), withTargetChange.end(), isChangeTarget), Equals(1));
+    });
+    it("shall change targets once per kind of interchangeable monsters", [] {
+      GameState state{Hero{}, {}, {}, 0, SimpleResources{}};
+      for (int i = 0; i < 3; ++i)
+        state.visibleMonsters.emplace_back(MonsterType::Goblin, Level{1});
+      state.visibleMonsters.emplace_back(MonsterType::Zombie, Level{1});
+      state.visibleMonsters.emplace_back(MonsterType::Zombie, Level{1});
+      const auto targets = [&state] {
+        std::vector<std::size_t> result;
+        for (const auto step : solver::ValidSteps{state, true})
+        {
+          const auto unpacked = step.unpack();
+          if (const auto changeTarget = std::get_if<ChangeTarget>(&unpacked))
+            result.push_back(changeTarget->targetIndex);
+        }
+        return result;
+      };
+      AssertThat(targets(), Equals(std::vector<std::size_t>{3}));
+      state.activeMonster = 4;
+      AssertThat(targets(), Equals(std::vector<std::size_t>{0}));
+      state.visibleMonsters[2].takeDamage(1, DamageType::Physical);
+      AssertThat(targets(), Equals(std::vector<std::size_t>{0, 2}));
+    });
+    it("shall tell apart monsters with a different piety history", [] {
+      GameState state{Hero{}, {}, {}, 0, SimpleResources{}};
+      for (int i = 0; i < 3; ++i)
+        state.visibleMonsters.emplace_back(MonsterType::Goblin, Level{1});
+      state.resources.altars = {God::TikkiTooki};
+      state = solver::apply(Follow{God::TikkiTooki}, std::move(state));
+      (void)state.hero.getFaith().receivedHit(state.visibleMonsters[1]);
+      std::vector<std::size_t> targets;
+      for (const auto step : solver::ValidSteps{state, true})
+      {
+        const auto unpacked = step.unpack();
+        if (const auto changeTarget = std::get_if<ChangeTarget>(&unpacked))
+          targets.push_back(changeTarget->targetIndex);
+      }
+      AssertThat(targets, Equals(std::vector<std::size_t>{1}));
+    });
+    it("shall not drop steps beyond its capacity", [] {
+      GameState state{Hero{}, {}, {}, 0, SimpleResources{}};
+      state.resources.altars.assign(solver::ValidSteps::capacity, God::TikkiTooki);
+      bool overflow = false;
+      try
+      {
+        const solver::ValidSteps validSteps{state, false};
+      }
+      catch (const std::length_error&)
+      {
+        overflow = true;
+      }
+      AssertThat(overflow, IsTrue());
+    });
+  });
+}
+
+void testMonteCarloTreeSearch()
+{
+  describe("Monte Carlo tree search", [] {
+    it("shall find a winning solution for a simple fight", [] {
+      const auto state = simpleFight();
+      auto control = SolverControl{};
+      const auto solution = runMonteCarloTreeSearch(state, control, {.iterationsPerStep = 200, .numThreads = 2});
+      AssertThat(solution.has_value(), IsTrue());
+      const auto finalState = solver::apply(*solution, state);
+      AssertThat(finalState.hero.isDefeated(), IsFalse());
+      AssertThat(finalState.visibleMonsters.empty(), IsTrue());
+    });
+  });
+}
+
+void testBounds()
+{
+  describe("Heuristic bounds", [] {
+    const auto fitness = StateFitnessRating1{};
+    it("shall not be below the rating of any scenario's initial state", [&] {
+      for (int i = 0; i <= static_cast<int>(Scenario::Last); ++i)
+      {
+        const auto scenario = static_cast<Scenario>(i);
+        const auto state = initialState(scenario);
+        AssertThat(solver::HeuristicBounds{state}.fitness(), IsGreaterThan(fitness(state) - 1));
+      }
+    });
+    it("shall require one step per death protection", [&] {
+      GameState state{Hero{HeroClass::Fighter}, {}, {}, 0, SimpleResources{}};
+      state.visibleMonsters.emplace_back(MonsterType::AnimatedArmour, Level{3});
+      const auto bounds = solver::HeuristicBounds{state};
+      AssertThat(bounds.stepsToWin().value_or(0), IsGreaterThan(3u));
+      AssertThat(bounds.within(3), Equals(bounds.fitness()));
+    });
+    it("shall distinguish defeat and victory", [&] {
+      GameState state{Hero{HeroClass::Fighter}, {}, {}, 0, SimpleResources{}};
+      AssertThat(solver::HeuristicBounds{state}.within(0), Equals(fitness.GAME_WON));
+      state.visibleMonsters.emplace_back(MonsterType::Goblin, Level{10});
+      while (!state.hero.isDefeated())
+        state.hero.loseHitPointsOutsideOfFight(state.hero.getHitPoints(), state.visibleMonsters);
+      AssertThat(solver::HeuristicBounds{state}.stepsToWin().has_value(), IsFalse());
+      AssertThat(solver::HeuristicBounds{state}.within(100), Equals(fitness.GAME_LOST));
+    });
+  });
+}
+
+void testTreeSearch()
+{
+  describe("Tree search", [] {
+    it("shall find a winning solution for a simple fight and report the depth", [] {
+      const auto state = simpleFight();
+      unsigned depth = 0;
+      auto control = SolverControl{{.onProgress = [&](const auto& progress) { depth = progress.depth; }}};
+      const auto solution =
+          runTreeSearch(state, control, {.maxDepth = 8, .timePerStep = std::chrono::milliseconds{500}});
+      AssertThat(solution.has_value(), IsTrue());
+      const auto finalState = solver::apply(*solution, state);
+      AssertThat(finalState.hero.isDefeated(), IsFalse());
+      AssertThat(finalState.visibleMonsters.empty(), IsTrue());
+      AssertThat(depth, IsGreaterThan(0u));
+    });
+    it("shall find a winning solution when splitting the search at every level", [] {
+      const auto state = simpleFight();
+      auto control = SolverControl{{.numThreads = 4}};
+      const auto solution = runTreeSearch(state, control, {.maxDepth = 8, .minSplitDepth = 1});
+      AssertThat(solution.has_value(), IsTrue());
+      const auto finalState = solver::apply(*solution, state);
+      AssertThat(finalState.hero.isDefeated(), IsFalse());
+      AssertThat(finalState.visibleMonsters.empty(), IsTrue());
+    });
+    it("shall find a winning solution with the heuristic cut", [] {
+      const auto state = simpleFight();
+      auto control = SolverControl{};
+      const auto solution = runTreeSearch(state, control, {.maxDepth = 8, .heuristicCut = true});
+      AssertThat(solution.has_value(), IsTrue());
+      const auto finalState = solver::apply(*solution, state);
+      AssertThat(finalState.hero.isDefeated(), IsFalse());
+      AssertThat(finalState.visibleMonsters.empty(), IsTrue());
+    });
+    it("shall give up on a hopeless fight without searching to the maximum depth", [] {
+      GameState state{Hero{HeroClass::Fighter}, {}, {}, 0, SimpleResources{}};
+      state.visibleMonsters.emplace_back(MonsterType::Goblin, Level{10});
+      state.resources.numHiddenTiles = 0;
+      auto control = SolverControl{{}};
+      const auto solution = runTreeSearch(state, control, {.maxDepth = 50, .timePerStep = std::chrono::seconds{60}});
+      AssertThat(solution.has_value(), IsFalse());
+      AssertThat(control.getMetrics().elapsedSeconds, IsLessThan(1.));
+    });
+    it("shall return the best line found so far when the time is up", [] {
+      const auto scenario = Scenario::HalflingTrial;
+      const auto state = initialState(scenario);
+      auto control = SolverControl{{.timeBudget = std::chrono::milliseconds{100}}};
+      const auto solution = runTreeSearch(state, control, {.maxDepth = 50, .timePerStep = std::chrono::seconds{10}});
+      AssertThat(solution.has_value(), IsTrue());
+      AssertThat(solution->empty(), IsFalse());
+      AssertThat(control.getMetrics().elapsedSeconds, IsLessThan(5.));
+    });
+  });
+}
+
+void testPortfolio()
+{
+  describe("Portfolio solver", [] {
+    it("shall return a winning solution and stop the other solvers", [] {
+      auto state = simpleFight();
+      auto control = SolverControl{{.timeBudget = std::chrono::seconds{60}}};
+      const auto solution = run(Solver::Portfolio, state, control);
+      AssertThat(solution.has_value(), IsTrue());
+      state.hero.add(HeroStatus::Pessimist);
+      const auto finalState = solver::apply(*solution, state);
+      AssertThat(finalState.hero.isDefeated(), IsFalse());
+      AssertThat(finalState.visibleMonsters.empty(), IsTrue());
+      AssertThat(control.getMetrics().elapsedSeconds, IsLessThan(60.));
+    });
+  });
+}
+
+void testGeneticAlgorithmIslands()
+{
+  describe("Genetic algorithm with islands", [] {
+    it("shall return a solution that does not defeat the hero", [] {
+      const auto scenario = Scenario::HalflingTrial;
+      const auto state = initialState(scenario);
+      auto control = SolverControl{};
+      const auto solution = runGeneticAlgorithm(
+          state, control, {.numGenerations = 10, .populationSize = 400, .numIslands = 4, .migrationInterval = 2});
+      AssertThat(solution.has_value(), IsTrue());
+      AssertThat(solver::apply(*solution, state).hero.isDefeated(), IsFalse());
+      AssertThat(control.getNumNodes(), IsGreaterThan(400u));
+    });
+    it("shall not generate a population once stopped", [] {
+      const auto scenario = Scenario::HalflingTrial;
+      const auto state = initialState(scenario);
+      std::stop_source stopSource;
+      stopSource.request_stop();
+      auto control = SolverControl{{.stopToken = stopSource.get_token()}};
+      runGeneticAlgorithm(state, control, {.numIslands = 4});
+      AssertThat(control.getNumNodes(), Equals(0u));
+    });
+  });
+}
+
+void testSolverControl()
+{
+  describe("Solver options", [] {
+    const auto scenario = Scenario::HalflingTrial;
+    const auto state = initialState(scenario);
+
+    it("shall stop when the node budget is exhausted and report progress", [&] {
+      std::vector<SolverProgress> reports;
+      const auto solution = run(Solver::GeneticAlgorithm, state,
+                                {.nodeBudget = 1500u, .onProgress = [&](const auto& progress) {
+                                   reports.push_back(progress);
+                                 }});
+      AssertThat(solution.has_value(), IsTrue());
+      AssertThat(reports.size(), Equals(1u));
+      AssertThat(reports.front().iteration, Equals(0u));
+      AssertThat(reports.front().numNodes, IsGreaterThan(1499u));
+    });
+    it("shall produce the same solution for the same seed", [&] {
+      const auto options = [] { return SolverOptions{.nodeBudget = 1500u, .numThreads = 1, .seed = 7}; };
+      const auto solution = run(Solver::GeneticAlgorithm, state, options());
+      AssertThat(solution.has_value(), IsTrue());
+      AssertThat(toString(*run(Solver::GeneticAlgorithm, state, options())), Equals(toString(*solution)));
+    });
+    it("shall count applied states and cache lookups", [&] {
+      auto control = SolverControl{{.nodeBudget = 1500u}};
+      run(Solver::GeneticAlgorithm, state, control);
+      const auto metrics = control.getMetrics();
+      AssertThat(metrics.numNodes, Equals(control.getNumNodes()));
+      AssertThat(metrics.counts.statesApplied, IsGreaterThan(metrics.numNodes));
+      AssertThat(metrics.counts.cacheHits + metrics.counts.cacheMisses, IsGreaterThan(0u));
+      AssertThat(metrics.lastIterationSeconds, IsGreaterThan(0.));
+    });
+    it("shall pass trace events to the trace sink", [&] {
+      auto trace = std::make_shared<RingBufferTraceSink>(2);
+      run(Solver::GeneticAlgorithm, state, {.nodeBudget = 1500u, .traceSink = trace});
+      const auto events = trace->getEvents();
+      AssertThat(events.size(), Equals(1u));
+      AssertThat(events.front().type, Equals("generation"));
+      AssertThat(events.front().solution.empty(), IsFalse());
+      trace->write({"first"});
+      trace->write({"second"});
+      AssertThat(trace->getEvents().front().type, Equals("first"));
+      AssertThat(trace->getEvents().size(), Equals(2u));
+    });
+    it("shall allow to cancel a background job", [&] {
+      SolverJob job{Solver::GeneticAlgorithm, state};
+      job.cancel();
+      while (!job.isDone())
+        std::this_thread::sleep_for(std::chrono::milliseconds{10});
+      AssertThat(job.isCancelled(), IsTrue());
+      AssertThat(job.getProgress().iteration, Equals(0u));
+    });
+  });
 }
 
 go_bandit([] {
   testHeuristics();
+  testStateHash();
+  testMacroSteps();
+  testPackedStep();
+  testValidSteps();
+  testMonteCarloTreeSearch();
+  testGeneticAlgorithmIslands();
+  testBounds();
+  testTreeSearch();
+  testPortfolio();
+  testSolverControl();
   // testGeneticSolver();
 });
 
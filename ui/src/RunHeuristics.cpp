@@ -4,6 +4,9 @@
 
 #include "imgui.h"
 
+#include <algorithm>
+#include <string>
+
 namespace ui
 {
   void RunHeuristics::update(const State& state)
@@ -54,6 +57,15 @@ namespace ui
 
     if (levelCatapultResult)
       output.emplace_back("Level catapult: "s + toString(*levelCatapultResult));
+
+    if (const auto& monsters = state.monsterPool; !monsters.empty())
+    {
+      const auto numMeleeWins = std::count_if(begin(monsters), end(monsters), [&hero](const Monster& monster) {
+        return !monster.isDefeated() && checkMeleeOnly(hero, monster);
+      });
+      output.emplace_back("Direct melee wins: "s + std::to_string(numMeleeWins) + " of " +
+                          std::to_string(monsters.size()) + " monster(s)");
+    }
   }
 
   void RunHeuristics::show() const
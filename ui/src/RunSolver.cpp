@@ -4,9 +4,12 @@
 #include "engine/Magic.hpp"
 #include "solver/GameState.hpp"
 #include "solver/Solver.hpp"
+#include "solver/SolverTools.hpp"
 
 #include "imgui.h"
 
+#include <cassert>
+
 namespace ui
 {
   GameState solverStateFromUIState(const State& state)
@@ -76,7 +79,8 @@ namespace ui
               if (hero.desecrate(desecrate.altar, monsters))
                 altars.erase(std::find(begin(altars), end(altars), GodOrPactmaker{desecrate.altar}));
             },
-            [&](ChangeTarget changeTarget) { state.activeMonster = changeTarget.targetIndex; }, [](NoOp) {}},
+            [&](ChangeTarget changeTarget) { state.activeMonster = changeTarget.targetIndex; }, [](NoOp) {},
+            [](Fight) { assert(false && "Macro steps are expanded before they are shown"); }},
         step);
   }
 
@@ -103,6 +107,47 @@ namespace ui
     }
   }
 
+  void showMetrics(const SolverMetrics& metrics)
+  {
+    if (!ImGui::CollapsingHeader("Metrics"))
+      return;
+    const auto& counts = metrics.counts;
+    const auto perSecond = [seconds = metrics.elapsedSeconds](std::uint64_t count) {
+      return seconds > 0 ? static_cast<double>(count) / seconds : 0.;
+    };
+    const auto numLookups = counts.cacheHits + counts.cacheMisses;
+    ImGui::Text("Elapsed: %.1f s", metrics.elapsedSeconds);
+    ImGui::Text("Nodes: %llu (%.0f/s)", static_cast<unsigned long long>(metrics.numNodes),
+                perSecond(metrics.numNodes));
+    ImGui::Text("States applied: %llu (%.0f/s)", static_cast<unsigned long long>(counts.statesApplied),
+                perSecond(counts.statesApplied));
+    ImGui::Text("Invalid steps: %llu", static_cast<unsigned long long>(counts.invalidSteps));
+    ImGui::Text("Cache hits: %llu / %llu (%.0f%%)", static_cast<unsigned long long>(counts.cacheHits),
+                static_cast<unsigned long long>(numLookups),
+                numLookups > 0 ? 100. * static_cast<double>(counts.cacheHits) / static_cast<double>(numLookups) : 0.);
+    ImGui::Text("Iteration: %.2f s (slowest %.2f s)", metrics.lastIterationSeconds, metrics.maxIterationSeconds);
+    if (metrics.peakMemoryBytes > 0)
+      ImGui::Text("Peak memory: %.1f MB", static_cast<double>(metrics.peakMemoryBytes) / (1024 * 1024));
+  }
+
+  // Most recent events first; the solution of an event is shown as tooltip
+  void showTrace(const RingBufferTraceSink& trace)
+  {
+    if (!ImGui::CollapsingHeader("Trace"))
+      return;
+    const auto events = trace.getEvents();
+    for (auto event = events.rbegin(); event != events.rend(); ++event)
+    {
+      ImGui::Text("%6.1fs %s %u: %i", event->seconds, event->type.c_str(), event->iteration, event->score);
+      if (ImGui::IsItemHovered())
+        createToolTip([&] {
+          ImGui::TextUnformatted(event->solution.c_str());
+          if (!event->details.empty())
+            ImGui::TextUnformatted(event->details.c_str());
+        });
+    }
+  }
+
   std::pair<ActionResultUI, bool> RunSolver::operator()(const State& state)
   {
     std::pair<ActionResultUI, bool> result;
@@ -110,11 +155,37 @@ namespace ui
     ImGui::SetWindowPos(ImVec2{5, 545}, ImGuiCond_FirstUseEver);
     ImGui::SetWindowSize(ImVec2{250, 170}, ImGuiCond_FirstUseEver);
     enumCombo("Solver", selectedSolver);
-    if (ImGui::SmallButton("Solve"))
+    if (job)
+      metrics = job->getMetrics();
+    if (job && job->isDone())
     {
-      solverSteps = run(selectedSolver, solverStateFromUIState(state));
+      const auto solution = job->getResult();
+      if (solution)
+        solverSteps = solver::expandMacros(*solution, *jobState);
       solutionIndex = 0;
       noSolutionFound = !solverSteps;
+      job.reset();
+    }
+    if (job)
+    {
+      const auto progress = job->getProgress();
+      if (job->isCancelled())
+        disabledSmallButton("Cancel", "Waiting for solver to stop");
+      else if (ImGui::SmallButton("Cancel"))
+        job->cancel();
+      ImGui::Text("Iteration %u, best score %i", progress.iteration, progress.bestScore);
+      if (progress.depth > 0)
+        ImGui::Text("Search depth %u", progress.depth);
+      ImGui::Text("%.0f nodes/s", progress.nodesPerSecond);
+    }
+    else if (ImGui::SmallButton("Solve"))
+    {
+      trace = std::make_shared<RingBufferTraceSink>();
+      jobState = solverStateFromUIState(state);
+      job = std::make_unique<SolverJob>(selectedSolver, *jobState, SolverOptions{.traceSink = trace});
+      metrics.reset();
+      solverSteps.reset();
+      noSolutionFound = false;
     }
     if (noSolutionFound)
       ImGui::TextUnformatted("No solution found.");
@@ -155,6 +226,10 @@ namespace ui
         }
       }
     }
+    if (metrics)
+      showMetrics(*metrics);
+    if (trace)
+      showTrace(*trace);
     ImGui::End();
     return result;
   }
@@ -3,9 +3,13 @@
 #include "ui/State.hpp"
 #include "ui/Utils.hpp"
 
+#include "solver/GameState.hpp"
 #include "solver/Solution.hpp"
 #include "solver/Solver.hpp"
+#include "solver/SolverJob.hpp"
+#include "solver/SolverTrace.hpp"
 
+#include <memory>
 #include <optional>
 #include <vector>
 
@@ -24,5 +28,12 @@ namespace ui
     size_t solutionIndex{0};
     bool noSolutionFound{false};
     Solver selectedSolver{Solver::GeneticAlgorithm};
+    // Solver running in the background, if any
+    std::unique_ptr<SolverJob> job;
+    // State the job was started from, needed to expand macro steps of its solution
+    std::optional<GameState> jobState;
+    // Counters and trace events of the running or most recent solver
+    std::optional<SolverMetrics> metrics;
+    std::shared_ptr<RingBufferTraceSink> trace;
   };
 } // namespace ui